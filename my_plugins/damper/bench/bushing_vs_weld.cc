@@ -0,0 +1,137 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：bench/bushing_vs_weld.cc
+//  说明：
+//    柔性连接的两种建模方式对比：
+//      • weld    : 带 solref 的 weld 等式约束，每个连接增加 6 行约束
+//      • bushing : mujoco.passive.bushing 插件，以被动力旋量实现，不进入求解器
+//    模型为一条水平悬臂的方块链，相邻方块（首块与 world）两两连接。
+//    输出每步耗时、平均约束行数 nefc 以及末端下垂量。
+//
+//    用法：spring_bushing_vs_weld [nbody] [nstep]
+//
+// -----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <mujoco/mujoco.h>
+
+namespace {
+
+constexpr double kSpacing = 0.2;   // 相邻方块间距
+constexpr double kStiffness = 2e4; // 平移刚度 (N/m)
+constexpr double kTorsion = 2e2;   // 转动刚度 (N·m/rad)
+
+std::string MakeModel(int nbody, bool bushing) {
+  std::string xml =
+      "<mujoco>\n"
+      "  <option timestep=\"0.002\">\n"
+      "    <flag contact=\"disable\"/>\n"
+      "  </option>\n";
+  if (bushing) {
+    const std::string k = std::to_string(kStiffness);
+    const std::string kr = std::to_string(kTorsion);
+    xml += "  <extension>\n"
+           "    <plugin plugin=\"mujoco.passive.bushing\">\n";
+    for (int i = 0; i < nbody; ++i) {
+      std::string parent = i ? "b" + std::to_string(i - 1) : "world";
+      xml += "      <instance name=\"j" + std::to_string(i) + "\">\n"
+             "        <config key=\"body1\" value=\"" + parent + "\"/>\n"
+             "        <config key=\"body2\" value=\"b" + std::to_string(i) + "\"/>\n"
+             "        <config key=\"stiffness\" value=\"" + k + " " + k + " " + k +
+             " " + kr + " " + kr + " " + kr + "\"/>\n"
+             "        <config key=\"damping\" value=\"20 20 20 0.2 0.2 0.2\"/>\n"
+             "      </instance>\n";
+    }
+    xml += "    </plugin>\n"
+           "  </extension>\n";
+  }
+  xml += "  <worldbody>\n";
+  for (int i = 0; i < nbody; ++i) {
+    xml += "    <body name=\"b" + std::to_string(i) + "\" pos=\"" +
+           std::to_string(kSpacing * (i + 1)) + " 0 1\">\n"
+           "      <freejoint/>\n"
+           "      <geom type=\"box\" size=\"0.05 0.05 0.05\" mass=\"0.5\"/>\n"
+           "    </body>\n";
+  }
+  xml += "  </worldbody>\n";
+  if (!bushing) {
+    xml += "  <equality>\n";
+    for (int i = 0; i < nbody; ++i) {
+      std::string parent = i ? "b" + std::to_string(i - 1) : "world";
+      xml += "    <weld body1=\"" + parent + "\" body2=\"b" + std::to_string(i) +
+             "\" solref=\"0.01 1\"/>\n";
+    }
+    xml += "  </equality>\n";
+  }
+  xml += "</mujoco>\n";
+  return xml;
+}
+
+mjModel* Compile(const std::string& xml) {
+  mjVFS vfs;
+  mj_defaultVFS(&vfs);
+  mj_addBufferVFS(&vfs, "links.xml", xml.data(), static_cast<int>(xml.size()));
+  char error[1000] = "";
+  mjModel* m = mj_loadXML("links.xml", &vfs, error, sizeof(error));
+  mj_deleteVFS(&vfs);
+  if (!m) {
+    std::fprintf(stderr, "compile error: %s\n", error);
+  }
+  return m;
+}
+
+bool Run(const char* label, int nbody, bool bushing, int nstep) {
+  mjModel* m = Compile(MakeModel(nbody, bushing));
+  if (!m) return false;
+  mjData* d = mj_makeData(m);
+
+  long long nefc = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nstep; ++i) {
+    mj_step(m, d);
+    nefc += d->nefc;
+  }
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  const mjtNum* tip = d->xpos + 3 * (m->nbody - 1);
+  std::printf("%-8s %8.2f us/step  nefc %6.1f  tip sag %.4f m\n", label,
+              1e6 * seconds / nstep, static_cast<double>(nefc) / nstep,
+              1 - tip[2]);
+
+  mj_deleteData(d);
+  mj_deleteModel(m);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int nbody = argc > 1 ? std::atoi(argv[1]) : 20;
+  int nstep = argc > 2 ? std::atoi(argv[2]) : 5000;
+
+  mj_loadPluginLibrary(DAMPER_PLUGIN_PATH);
+
+  std::printf("%d links, %d steps\n", nbody, nstep);
+  if (!Run("weld", nbody, false, nstep)) return 1;
+  if (!Run("bushing", nbody, true, nstep)) return 1;
+  return 0;
+}
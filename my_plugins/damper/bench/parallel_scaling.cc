@@ -0,0 +1,140 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：bench/parallel_scaling.cc
+//  说明：
+//    弹簧插件在线程池上的扩展性测试。模型为 side×side 的自由小球网格，
+//    相邻小球（水平、竖直）以弹簧相连，默认 side=71，约 1 万根弹簧。
+//    对 0..N 个工作线程分别重复调用 mj_passive 并统计平均耗时。
+//
+//    用法：spring_parallel_scaling [max_workers] [side] [iterations]
+//
+// -----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <mujoco/mujoco.h>
+
+namespace {
+
+std::string Node(int i, int j) {
+  return "p" + std::to_string(i) + "_" + std::to_string(j);
+}
+
+std::string MakeLattice(int side) {
+  std::string pairs;
+  for (int i = 0; i < side; ++i) {
+    for (int j = 0; j < side; ++j) {
+      if (i + 1 < side) pairs += Node(i, j) + ":" + Node(i + 1, j) + " ";
+      if (j + 1 < side) pairs += Node(i, j) + ":" + Node(i, j + 1) + " ";
+    }
+  }
+
+  std::string xml =
+      "<mujoco>\n"
+      "  <option><flag contact=\"disable\" gravity=\"disable\"/></option>\n"
+      "  <extension>\n"
+      "    <plugin plugin=\"mujoco.passive.spring\">\n"
+      "      <instance name=\"lattice\">\n"
+      "        <config key=\"stiffness\" value=\"100\"/>\n"
+      "        <config key=\"damping\" value=\"1\"/>\n"
+      "        <config key=\"pairs\" value=\"" + pairs + "\"/>\n"
+      "      </instance>\n"
+      "    </plugin>\n"
+      "  </extension>\n"
+      "  <worldbody>\n";
+  for (int i = 0; i < side; ++i) {
+    for (int j = 0; j < side; ++j) {
+      xml += "    <body name=\"" + Node(i, j) + "\" pos=\"" +
+             std::to_string(0.1 * i) + " " + std::to_string(0.1 * j) +
+             " 0\"><freejoint/><geom size=\"0.01\"/></body>\n";
+    }
+  }
+  xml += "  </worldbody>\n</mujoco>\n";
+  return xml;
+}
+
+mjModel* Compile(const std::string& xml) {
+  mjVFS vfs;
+  mj_defaultVFS(&vfs);
+  mj_addBufferVFS(&vfs, "lattice.xml", xml.data(), static_cast<int>(xml.size()));
+  char error[1000] = "";
+  mjModel* m = mj_loadXML("lattice.xml", &vfs, error, sizeof(error));
+  mj_deleteVFS(&vfs);
+  if (!m) {
+    std::fprintf(stderr, "compile error: %s\n", error);
+  }
+  return m;
+}
+
+// 返回单次 mj_passive 的平均耗时（微秒）
+double TimePassive(const mjModel* m, int workers, int iterations) {
+  mjData* d = mj_makeData(m);
+  mjThreadPool* pool = nullptr;
+  if (workers > 0) {
+    pool = mju_threadPoolCreate(workers);
+    mju_bindThreadPool(d, pool);
+  }
+
+  // 给网格一个随机扰动，使弹簧处于非平衡状态
+  for (int i = 0; i < m->nv; ++i) {
+    d->qvel[i] = 0.01 * ((i * 7919) % 13 - 6);
+  }
+  mj_forward(m, d);
+
+  mj_passive(m, d);  // 预热
+  auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < iterations; ++k) {
+    mj_passive(m, d);
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  mj_deleteData(d);
+  if (pool) {
+    mju_threadPoolDestroy(pool);
+  }
+  return std::chrono::duration<double, std::micro>(stop - start).count() /
+         iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int max_workers = argc > 1 ? std::atoi(argv[1])
+                             : static_cast<int>(std::thread::hardware_concurrency());
+  int side = argc > 2 ? std::atoi(argv[2]) : 71;
+  int iterations = argc > 3 ? std::atoi(argv[3]) : 200;
+
+  mj_loadPluginLibrary(DAMPER_PLUGIN_PATH);
+  mjModel* m = Compile(MakeLattice(side));
+  if (!m) return 1;
+  std::printf("lattice %dx%d: %d springs, nv=%d\n", side, side,
+              2 * side * (side - 1), m->nv);
+
+  double base = 0;
+  std::printf("%8s %14s %8s\n", "workers", "mj_passive us", "speedup");
+  for (int workers = 0; workers <= max_workers; ++workers) {
+    double t = TimePassive(m, workers, iterations);
+    if (workers == 0) base = t;
+    std::printf("%8d %14.1f %8.2f\n", workers, t, base / t);
+  }
+
+  mj_deleteModel(m);
+  return 0;
+}
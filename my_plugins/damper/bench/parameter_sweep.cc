@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：bench/parameter_sweep.cc
+//  说明：
+//    刚度扫描的两种做法对比：
+//      • recompile : 每个参数点重新生成 XML、编译 mjModel 并创建 mjData
+//      • state     : 只编译一次，每个参数点 mj_resetData 后经 mj_setState
+//                    (mjSTATE_PLUGIN) 写入新的刚度
+//    两种做法的每个 rollout 末状态应逐位一致，程序同时做此校验。
+//
+//    用法：spring_parameter_sweep [npoint] [nbody] [nstep]
+//
+// -----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace {
+
+constexpr double kSpacing = 0.1;  // 相邻小球间距 = 自然长度
+
+// 第 i 个参数点的刚度，取整数值使 XML 文本能精确表示
+double Stiffness(int i) { return 100.0 + 10.0 * i; }
+
+std::string MakeModel(double stiffness, int nbody) {
+  std::string xml =
+      "<mujoco>\n"
+      "  <option timestep=\"0.001\">\n"
+      "    <flag contact=\"disable\"/>\n"
+      "  </option>\n"
+      "  <extension>\n"
+      "    <plugin plugin=\"mujoco.passive.spring\">\n"
+      "      <instance name=\"chain\">\n"
+      "        <config key=\"pairs\" value=\"world:n0\"/>\n"
+      "        <config key=\"chain\" value=\"n*\"/>\n"
+      "        <config key=\"stiffness\" value=\"" + std::to_string(stiffness) + "\"/>\n"
+      "        <config key=\"damping\" value=\"1\"/>\n"
+      "        <config key=\"restlength\" value=\"" + std::to_string(kSpacing) + "\"/>\n"
+      "      </instance>\n"
+      "    </plugin>\n"
+      "  </extension>\n"
+      "  <worldbody>\n";
+  for (int i = 0; i < nbody; ++i) {
+    xml += "    <body name=\"n" + std::to_string(i) + "\" pos=\"0 0 " +
+           std::to_string(-1.2 * kSpacing * (i + 1)) + "\">\n"
+           "      <freejoint/>\n"
+           "      <geom type=\"sphere\" size=\"0.02\" mass=\"0.05\"/>\n"
+           "    </body>\n";
+  }
+  xml += "  </worldbody>\n</mujoco>\n";
+  return xml;
+}
+
+mjModel* Compile(const std::string& xml) {
+  mjVFS vfs;
+  mj_defaultVFS(&vfs);
+  mj_addBufferVFS(&vfs, "sweep.xml", xml.data(), static_cast<int>(xml.size()));
+  char error[1000] = "";
+  mjModel* m = mj_loadXML("sweep.xml", &vfs, error, sizeof(error));
+  mj_deleteVFS(&vfs);
+  if (!m) {
+    std::fprintf(stderr, "compile error: %s\n", error);
+  }
+  return m;
+}
+
+void Rollout(const mjModel* m, mjData* d, int nstep) {
+  for (int i = 0; i < nstep; ++i) {
+    mj_step(m, d);
+  }
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int npoint = argc > 1 ? std::atoi(argv[1]) : 200;
+  int nbody = argc > 2 ? std::atoi(argv[2]) : 20;
+  int nstep = argc > 3 ? std::atoi(argv[3]) : 100;
+
+  mj_loadPluginLibrary(DAMPER_PLUGIN_PATH);
+
+  // ---------- 1) 每个参数点重新编译 ----------
+  std::vector<std::vector<mjtNum>> recompiled(npoint);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < npoint; ++i) {
+    mjModel* m = Compile(MakeModel(Stiffness(i), nbody));
+    if (!m) return 1;
+    mjData* d = mj_makeData(m);
+    Rollout(m, d, nstep);
+    recompiled[i].assign(d->qpos, d->qpos + m->nq);
+    mj_deleteData(d);
+    mj_deleteModel(m);
+  }
+  double recompile_time = Seconds(start);
+
+  // ---------- 2) 一次编译，经 plugin_state 修改刚度 ----------
+  start = std::chrono::steady_clock::now();
+  mjModel* m = Compile(MakeModel(Stiffness(0), nbody));
+  if (!m) return 1;
+  mjData* d = mj_makeData(m);
+  const int size = mj_stateSize(m, mjSTATE_PLUGIN);
+  std::vector<mjtNum> state(size);
+  const int nspring = m->plugin_statenum[0] / 3;  // 前 nspring 个为刚度
+  int mismatch = 0;
+  for (int i = 0; i < npoint; ++i) {
+    mj_resetData(m, d);
+    mj_getState(m, d, state.data(), mjSTATE_PLUGIN);
+    for (int j = 0; j < nspring; ++j) {
+      state[m->plugin_stateadr[0] + j] = Stiffness(i);
+    }
+    mj_setState(m, d, state.data(), mjSTATE_PLUGIN);
+    Rollout(m, d, nstep);
+    if (std::memcmp(d->qpos, recompiled[i].data(), sizeof(mjtNum) * m->nq)) {
+      ++mismatch;
+    }
+  }
+  double state_time = Seconds(start);
+  mj_deleteData(d);
+  mj_deleteModel(m);
+
+  std::printf("%d points, %d springs, %d steps per rollout\n", npoint, nspring,
+              nstep);
+  std::printf("%-10s %8.3f s  (%.3f ms/point)\n", "recompile", recompile_time,
+              1e3 * recompile_time / npoint);
+  std::printf("%-10s %8.3f s  (%.3f ms/point)\n", "state", state_time,
+              1e3 * state_time / npoint);
+  std::printf("speedup %.1fx, mismatching rollouts: %d\n",
+              recompile_time / state_time, mismatch);
+  return mismatch ? 1 : 0;
+}
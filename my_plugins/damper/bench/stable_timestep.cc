@@ -0,0 +1,198 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：bench/stable_timestep.cc
+//  说明：
+//    对比弹簧插件在 implicit=false / implicit=true 下的最大稳定步长。
+//    模型为一条悬挂在世界原点下方的小球链，球之间以刚性弹簧相连，
+//    积分器为 implicitfast。对每个步长仿真固定时长，若出现非有限值、
+//    MuJoCo 数值警告或链条飞散，则视为不稳定。
+//
+//    只看是否发散会把被软化的弹簧也算作稳定（implicit=true 时弹簧刚度
+//    实际为 α k，静态伸长随步长增大，见 spring_damper.h），因此另做精度
+//    检查：把链条放在精确的静平衡位置上仿真同样时长，顶端弹簧的平均
+//    伸长须在 n m g / k 的 kTolerance 以内。两种步长上限都会报告，
+//    倍数按精确步长计算。
+//
+//    用法：spring_stable_timestep [stiffness] [mass] [nbody]
+//
+// -----------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include <mujoco/mujoco.h>
+
+namespace {
+
+constexpr double kSpacing = 0.1;    // 相邻小球间距 = 自然长度
+constexpr double kDuration = 2.0;   // 每个步长的仿真时长 (s)
+constexpr double kTolerance = 0.1;  // 顶端弹簧静态伸长的允许相对误差
+
+std::string MakeModel(double stiffness, double mass, int nbody, bool implicit,
+                      double timestep) {
+  std::string xml =
+      "<mujoco>\n"
+      "  <option integrator=\"implicitfast\" timestep=\"" +
+      std::to_string(timestep) + "\">\n"
+      "    <flag contact=\"disable\"/>\n"
+      "  </option>\n"
+      "  <extension>\n"
+      "    <plugin plugin=\"mujoco.passive.spring\">\n"
+      "      <instance name=\"chain\">\n"
+      "        <config key=\"pairs\" value=\"world:n0\"/>\n"
+      "        <config key=\"chain\" value=\"n*\"/>\n"
+      "        <config key=\"stiffness\" value=\"" + std::to_string(stiffness) + "\"/>\n"
+      "        <config key=\"damping\" value=\"1\"/>\n"
+      "        <config key=\"restlength\" value=\"" + std::to_string(kSpacing) + "\"/>\n"
+      "        <config key=\"implicit\" value=\"" + (implicit ? "true" : "false") + "\"/>\n"
+      "      </instance>\n"
+      "    </plugin>\n"
+      "  </extension>\n"
+      "  <worldbody>\n";
+  for (int i = 0; i < nbody; ++i) {
+    // 初始略微拉伸，使弹簧从非平衡位置开始振荡
+    xml += "    <body name=\"n" + std::to_string(i) + "\" pos=\"0 0 " +
+           std::to_string(-1.2 * kSpacing * (i + 1)) + "\">\n"
+           "      <freejoint/>\n"
+           "      <geom type=\"sphere\" size=\"0.02\" mass=\"" +
+           std::to_string(mass) + "\"/>\n"
+           "    </body>\n";
+  }
+  xml += "  </worldbody>\n</mujoco>\n";
+  return xml;
+}
+
+mjModel* Compile(const std::string& xml) {
+  mjVFS vfs;
+  mj_defaultVFS(&vfs);
+  mj_addBufferVFS(&vfs, "chain.xml", xml.data(), static_cast<int>(xml.size()));
+  char error[1000] = "";
+  mjModel* m = mj_loadXML("chain.xml", &vfs, error, sizeof(error));
+  mj_deleteVFS(&vfs);
+  if (!m) {
+    std::fprintf(stderr, "compile error: %s\n", error);
+  }
+  return m;
+}
+
+bool Stable(const mjModel* m, mjData* d, int nbody) {
+  const double limit = 10 * kSpacing * nbody;  // 远超链长即视为发散
+  while (d->time < kDuration) {
+    mj_step(m, d);
+    if (d->warning[mjWARN_BADQACC].number || d->warning[mjWARN_BADQVEL].number ||
+        d->warning[mjWARN_BADQPOS].number) {
+      return false;
+    }
+    for (int i = 0; i < m->nq; ++i) {
+      if (!std::isfinite(d->qpos[i]) || std::fabs(d->qpos[i]) > limit) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 把链条放到静平衡位置（第 j 根弹簧承受其下 n - j 个小球的重量），
+// 仿真 kDuration 后返回顶端弹簧平均伸长相对 n m g / k 的误差；
+// 发散时返回无穷大
+double EquilibriumError(const mjModel* m, mjData* d, double stiffness,
+                        double mass, int nbody) {
+  const double g = -m->opt.gravity[2];
+  mj_resetData(m, d);
+  double z = 0;
+  for (int i = 0; i < nbody; ++i) {
+    z -= kSpacing + (nbody - i) * mass * g / stiffness;
+    d->qpos[m->jnt_qposadr[i] + 2] = z;
+  }
+
+  const double expected = nbody * mass * g / stiffness;
+  const int top = m->jnt_qposadr[0] + 2;
+  double sum = 0;
+  long count = 0;
+  while (d->time < kDuration) {
+    mj_step(m, d);
+    if (!std::isfinite(d->qpos[top])) {
+      return std::numeric_limits<double>::infinity();
+    }
+    sum += -d->qpos[top] - kSpacing;
+    ++count;
+  }
+  return std::fabs(sum / count / expected - 1);
+}
+
+struct Limits {
+  double stable = 0;     // 不发散的最大步长
+  double accurate = 0;   // 同时满足精度检查的最大步长
+};
+
+// 从小到大扫描步长，分别返回第一次失稳、第一次超出精度之前的最大步长
+Limits MaxTimestep(double stiffness, double mass, int nbody, bool implicit) {
+  Limits limits;
+  mjModel* m = Compile(MakeModel(stiffness, mass, nbody, implicit, 1e-4));
+  if (!m) return limits;
+  mjData* d = mj_makeData(m);
+
+  bool accurate = true;
+  for (double h = 1e-4; h < 0.1; h *= 1.25) {
+    m->opt.timestep = h;
+    mj_resetData(m, d);
+    if (!Stable(m, d, nbody)) break;
+    limits.stable = h;
+    if (accurate &&
+        EquilibriumError(m, d, stiffness, mass, nbody) <= kTolerance) {
+      limits.accurate = h;
+    } else {
+      accurate = false;
+    }
+  }
+
+  mj_deleteData(d);
+  mj_deleteModel(m);
+  return limits;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double stiffness = argc > 1 ? std::strtod(argv[1], nullptr) : 1e4;
+  double mass = argc > 2 ? std::strtod(argv[2], nullptr) : 0.05;
+  int nbody = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  mj_loadPluginLibrary(DAMPER_PLUGIN_PATH);
+
+  // 显式积分下的理论上限：h < 2 / ω，ω = sqrt(k W)，W = 2 / m
+  double omega = std::sqrt(stiffness * 2 / mass);
+  std::printf("chain: %d bodies, k=%g N/m, m=%g kg, explicit bound 2/w=%.3g s\n",
+              nbody, stiffness, mass, 2 / omega);
+
+  Limits explicit_limits = MaxTimestep(stiffness, mass, nbody, false);
+  Limits implicit_limits = MaxTimestep(stiffness, mass, nbody, true);
+  std::printf("max timestep: stable, and with top extension within %.0f%% "
+              "of n*m*g/k\n", 100 * kTolerance);
+  std::printf("%-10s stable %.4g s  accurate %.4g s\n", "explicit",
+              explicit_limits.stable, explicit_limits.accurate);
+  std::printf("%-10s stable %.4g s  accurate %.4g s\n", "implicit",
+              implicit_limits.stable, implicit_limits.accurate);
+  if (explicit_limits.accurate > 0) {
+    std::printf("ratio %.2fx (accurate), %.2fx (stable only)\n",
+                implicit_limits.accurate / explicit_limits.accurate,
+                implicit_limits.stable / explicit_limits.stable);
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "body_chain.h"
+
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+
+BodyChains::BodyChains(const mjModel* m, const std::vector<int>& bodies)
+    : adr_(m->nbody, 0), num_(m->nbody, 0) {
+  std::vector<bool> cached(m->nbody, false);
+  for (int body : bodies) {
+    if (cached[body]) continue;
+    cached[body] = true;
+
+    // 找到本刚体或最近的带自由度祖先的最后一个 DOF，再沿 dof_parentid 回溯到根
+    int dof = -1;
+    for (int b = body; b > 0; b = m->body_parentid[b]) {
+      if (m->body_dofnum[b] > 0) {
+        dof = m->body_dofadr[b] + m->body_dofnum[b] - 1;
+        break;
+      }
+    }
+    adr_[body] = static_cast<int>(dofs_.size());
+    for (; dof >= 0; dof = m->dof_parentid[dof]) {
+      dofs_.push_back(dof);
+    }
+    num_[body] = static_cast<int>(dofs_.size()) - adr_[body];
+  }
+}
+
+void BodyChains::AddForce(const mjModel* m, const mjData* d, int body,
+                          const mjtNum force[3], const mjtNum point[3],
+                          mjtNum* qfrc) const {
+  const int n = num_[body];
+  if (!n) return;
+
+  // 平移雅可比列：cdof_lin + cdof_ang × r，r 为作用点相对子树质心的偏移，
+  // 因此 J^T f = cdof_lin·f + cdof_ang·(r × f)
+  mjtNum offset[3], moment[3];
+  mju_sub3(offset, point, d->subtree_com + 3 * m->body_rootid[body]);
+  mju_cross(moment, offset, force);
+
+  const int* dof = dofs_.data() + adr_[body];
+  for (int j = 0; j < n; ++j) {
+    const mjtNum* cdof = d->cdof + 6 * dof[j];  // [角; 线]
+    qfrc[dof[j]] += mju_dot3(cdof, moment) + mju_dot3(cdof + 3, force);
+  }
+}
+
+void BodyChains::AddForceTorque(const mjModel* m, const mjData* d, int body,
+                                const mjtNum force[3], const mjtNum torque[3],
+                                const mjtNum point[3], mjtNum* qfrc) const {
+  const int n = num_[body];
+  if (!n) return;
+
+  // 转动雅可比列为 cdof_ang，力矩直接叠加到 r × f 上
+  mjtNum offset[3], moment[3];
+  mju_sub3(offset, point, d->subtree_com + 3 * m->body_rootid[body]);
+  mju_cross(moment, offset, force);
+  mju_addTo3(moment, torque);
+
+  const int* dof = dofs_.data() + adr_[body];
+  for (int j = 0; j < n; ++j) {
+    const mjtNum* cdof = d->cdof + 6 * dof[j];  // [角; 线]
+    qfrc[dof[j]] += mju_dot3(cdof, moment) + mju_dot3(cdof + 3, force);
+  }
+}
+
+}  // namespace mujoco::plugin::passive
@@ -0,0 +1,60 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_BODY_CHAIN_H_
+#define MUJOCO_PLUGIN_PASSIVE_BODY_CHAIN_H_
+
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+
+// Cached sparsity of body Jacobians: for every body of interest, the DOFs its
+// motion depends on (its own and its ancestors'), built once at init from
+// body_dofadr/body_parentid and dof_parentid. Forces are then mapped to
+// generalized forces with a sparse J^T product that touches only those DOFs,
+// instead of the dense O(nv) mj_applyFT pattern.
+class BodyChains {
+ public:
+  BodyChains() = default;
+
+  // Caches the DOF chains of `bodies` (duplicates are allowed).
+  BodyChains(const mjModel* m, const std::vector<int>& bodies);
+
+  // Adds J^T f to qfrc for a world-frame force f applied at world `point` on
+  // `body`. Requires d->cdof and d->subtree_com (position stage).
+  void AddForce(const mjModel* m, const mjData* d, int body,
+                const mjtNum force[3], const mjtNum point[3],
+                mjtNum* qfrc) const;
+
+  // Adds J^T [f; t] to qfrc for a world-frame force f applied at world `point`
+  // on `body` plus a world-frame torque t.
+  void AddForceTorque(const mjModel* m, const mjData* d, int body,
+                      const mjtNum force[3], const mjtNum torque[3],
+                      const mjtNum point[3], mjtNum* qfrc) const;
+
+  // DOFs of `body`'s chain, ordered from the body towards the root.
+  const int* dofs(int body) const { return dofs_.data() + adr_[body]; }
+  int ndof(int body) const { return num_[body]; }
+
+ private:
+  std::vector<int> adr_;   // Start of each body's chain in dofs_, by body id
+  std::vector<int> num_;   // Chain length by body id, 0 if not cached
+  std::vector<int> dofs_;
+};
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_BODY_CHAIN_H_
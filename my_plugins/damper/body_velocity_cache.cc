@@ -0,0 +1,142 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "body_velocity_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+namespace {
+
+// 进程内注册表：每个 mjData 对应一个缓存
+std::mutex registry_mutex;
+std::unordered_map<const mjData*, std::unique_ptr<BodyVelocityCache>>& Registry() {
+  static auto* registry =
+      new std::unordered_map<const mjData*, std::unique_ptr<BodyVelocityCache>>;
+  return *registry;
+}
+
+}  // namespace
+
+BodyVelocityCache* BodyVelocityCache::Acquire(const mjModel* m, const mjData* d,
+                                              int instance,
+                                              const std::vector<int>& bodies) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto& slot = Registry()[d];
+  if (!slot) {
+    slot.reset(new BodyVelocityCache(m->nbody));
+  }
+  slot->Register(instance, bodies);
+
+  // 记录 body_rootid，Fill 时无需访问 mjModel
+  slot->rootid_.resize(slot->bodies_.size());
+  for (std::size_t i = 0; i < slot->bodies_.size(); ++i) {
+    slot->rootid_[i] = m->body_rootid[slot->bodies_[i]];
+  }
+  return slot.get();
+}
+
+void BodyVelocityCache::Release(const mjData* d, int instance) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto it = Registry().find(d);
+  if (it == Registry().end()) return;
+  if (it->second->Unregister(instance)) {
+    Registry().erase(it);
+  }
+}
+
+BodyVelocityCache::BodyVelocityCache(int nbody)
+    : refcount_(nbody, 0), vel_(3 * nbody, 0),
+      fill_time_(std::numeric_limits<mjtNum>::quiet_NaN()) {}
+
+void BodyVelocityCache::Register(int instance, const std::vector<int>& bodies) {
+  User user{instance, bodies};
+  std::sort(user.bodies.begin(), user.bodies.end());
+  user.bodies.erase(std::unique(user.bodies.begin(), user.bodies.end()),
+                    user.bodies.end());
+  for (int body : user.bodies) {
+    if (body > 0 && refcount_[body]++ == 0) {  // 世界刚体速度恒为零
+      bodies_.push_back(body);
+    }
+  }
+  std::sort(bodies_.begin(), bodies_.end());
+
+  auto pos = std::lower_bound(
+      users_.begin(), users_.end(), instance,
+      [](const User& u, int i) { return u.instance < i; });
+  users_.insert(pos, std::move(user));
+}
+
+bool BodyVelocityCache::Unregister(int instance) {
+  auto it = std::find_if(users_.begin(), users_.end(),
+                         [instance](const User& u) { return u.instance == instance; });
+  if (it == users_.end()) return users_.empty();
+  for (int body : it->bodies) {
+    if (body > 0) --refcount_[body];
+  }
+  users_.erase(it);
+
+  std::vector<int> kept;
+  std::vector<int> kept_root;
+  for (std::size_t i = 0; i < bodies_.size(); ++i) {
+    if (refcount_[bodies_[i]] > 0) {
+      kept.push_back(bodies_[i]);
+      kept_root.push_back(rootid_[i]);
+    }
+  }
+  bodies_.swap(kept);
+  rootid_.swap(kept_root);
+  return users_.empty();
+}
+
+const mjtNum* BodyVelocityCache::Update(const mjData* d, int instance) {
+  auto it = std::lower_bound(
+      users_.begin(), users_.end(), instance,
+      [](const User& u, int i) { return u.instance < i; });
+  if (it == users_.end() || it->instance != instance) return vel_.data();
+
+  // 时间变化，或本实例已读过当前结果，说明进入了新的一次计算：
+  // 不论 passive 还是传感器阶段，本次最先调用的实例负责刷新
+  if (d->time != fill_time_ || it->read) {
+    Fill(d);
+    fill_time_ = d->time;
+    for (User& user : users_) user.read = false;
+  }
+  it->read = true;
+  return vel_.data();
+}
+
+// 与 mj_objectVelocity(mjOBJ_XBODY, world) 的线速度部分相同，取刚体坐标
+// 原点 xpos（不是质心 xipos），与施力点一致：
+//   v = v_com + ω × (xpos - subtree_com[root])，cvel = [ω; v_com]
+void BodyVelocityCache::Fill(const mjData* d) {
+  const int n = static_cast<int>(bodies_.size());
+  for (int i = 0; i < n; ++i) {
+    const int body = bodies_[i];
+    const mjtNum* cvel = d->cvel + 6 * body;
+    mjtNum offset[3], spin[3];
+    mju_sub3(offset, d->xpos + 3 * body, d->subtree_com + 3 * rootid_[i]);
+    mju_cross(spin, cvel, offset);
+    mju_add3(vel_.data() + 3 * body, cvel + 3, spin);
+  }
+}
+
+}  // namespace mujoco::plugin::passive
@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_BODY_VELOCITY_CACHE_H_
+#define MUJOCO_PLUGIN_PASSIVE_BODY_VELOCITY_CACHE_H_
+
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+
+// World-frame linear velocities of body frame origins (the points d->xpos,
+// i.e. mj_objectVelocity with mjOBJ_XBODY), shared by every passive plugin
+// instance of this library on one mjData. Forces are applied at the same
+// points (see BodyChains::AddForce).
+//
+// Each instance registers the bodies it reads. The cache is refilled on the
+// first Update() of each evaluation by whichever instance asks first, only for
+// registered bodies. A new evaluation is detected when d->time has changed
+// since the last fill, or when the calling instance has already read the
+// current fill. This holds in the passive stage and in the sensor stage alike,
+// e.g. when passive forces are disabled and only Sense() runs.
+class BodyVelocityCache {
+ public:
+  // Returns the cache of d, creating it on first use, and registers `bodies`
+  // for `instance`. Safe to call concurrently for different mjData.
+  static BodyVelocityCache* Acquire(const mjModel* m, const mjData* d,
+                                    int instance, const std::vector<int>& bodies);
+
+  // Unregisters `instance`; the cache is freed with its last user.
+  static void Release(const mjData* d, int instance);
+
+  // Returns 3*nbody velocities, refreshed for this evaluation if needed.
+  const mjtNum* Update(const mjData* d, int instance);
+
+  // Velocities from the most recent Update(), indexed by 3*body.
+  const mjtNum* data() const { return vel_.data(); }
+
+ private:
+  explicit BodyVelocityCache(int nbody);
+
+  void Register(int instance, const std::vector<int>& bodies);
+  bool Unregister(int instance);  // returns true when no user is left
+  void Fill(const mjData* d);
+
+  struct User {
+    int instance;
+    std::vector<int> bodies;
+    bool read = false;            // has read the current fill
+  };
+  std::vector<User> users_;       // sorted by instance
+  std::vector<int> refcount_;     // users per body
+  std::vector<int> bodies_;       // bodies with refcount_ > 0
+  std::vector<int> rootid_;       // body_rootid of bodies_
+  std::vector<mjtNum> vel_;       // 3*nbody
+  mjtNum fill_time_;              // d->time of the current fill, NaN if none
+};
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_BODY_VELOCITY_CACHE_H_
@@ -0,0 +1,303 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：bushing.cc
+//  说明：
+//    六自由度衬套 (bushing) PASSIVE 插件：在两个刚体上各固定一个坐标系，
+//    以 6x6 刚度 / 阻尼矩阵（对角或满阵）作用于两坐标系间的相对位姿误差，
+//    产生一对大小相等、方向相反的力旋量，经缓存的稀疏 J^T 累加到
+//    qfrc_passive。与 weld 等式约束不同，它不增加约束行 (nefc)，
+//    也不引入额外自由度，求解器不为其付出任何代价。
+//
+//    误差定义在 body1 的坐标系 F1 中：
+//      平移误差 e_t = R1^T (p2 - p1)
+//      转动误差 e_r = log(q1^-1 q2)（四元数对数映射，即旋转向量）
+//    速度误差取 body2 与 body1 上与 p2 重合点的相对速度、相对角速度，
+//    力旋量 w = -(K e + C e_dot) 作用于 body2，反向作用于 body1。
+//
+//    支持的 XML 属性：
+//      • body1 / body2 : 两个刚体名称（可为 world）
+//      • stiffness     : 6 个数为对角阵 [平移 x y z, 转动 x y z]，
+//                        36 个数为按行排列的满阵
+//      • damping       : 同上，缺省为 0
+//      • pos1 / quat1  : F1 在 body1 局部坐标系中的位姿
+//      • pos2 / quat2  : F2 在 body2 局部坐标系中的位姿
+//                        四项都未给出时，F1、F2 均取 body2 在 qpos0 处的位姿，
+//                        初始状态无载荷（与 weld 缺省 relpose 的含义一致）
+//
+// -----------------------------------------------------------------------------
+
+#include "bushing.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+namespace {  // 匿名命名空间，限制辅助函数作用域
+
+// 从插件配置读取 string 类型，可缺省
+std::optional<std::string> ReadStringAttr(const mjModel* m, int instance,
+                                          const char* attr) {
+  const char* value = mj_getPluginConfig(m, instance, attr);
+  if (value == nullptr || value[0] == '\0') {
+    return std::nullopt;  // 未提供
+  }
+  return std::string(value);
+}
+
+// 读取以空白分隔的数值列表，可缺省
+std::optional<std::vector<mjtNum>> ReadVectorAttr(const mjModel* m, int instance,
+                                                  const char* attr) {
+  auto value = ReadStringAttr(m, instance, attr);
+  if (!value) return std::nullopt;
+  std::vector<mjtNum> result;
+  std::istringstream stream(*value);
+  mjtNum x;
+  while (stream >> x) result.push_back(x);
+  return result;
+}
+
+// 按名称解析刚体 ID，失败时给出警告
+int FindBody(const mjModel* m, const std::string& name) {
+  int id = mj_name2id(m, mjOBJ_BODY, name.c_str());
+  if (id < 0) {
+    mju_warning("Bushing plugin: could not find body '%s'.", name.c_str());
+  }
+  return id;
+}
+
+// 读取 6x6 矩阵：6 个数为对角阵，36 个数为满阵；返回是否为满阵
+std::optional<bool> ReadMatrix6(const mjModel* m, int instance, const char* attr,
+                                std::array<mjtNum, 36>* matrix) {
+  auto values = ReadVectorAttr(m, instance, attr);
+  if (!values) return false;  // 缺省：零矩阵
+  if (values->size() == 6) {
+    for (int k = 0; k < 6; ++k) (*matrix)[7 * k] = (*values)[k];
+    return false;
+  }
+  if (values->size() == 36) {
+    std::copy(values->begin(), values->end(), matrix->begin());
+    return true;
+  }
+  mju_warning("Bushing plugin: '%s' needs 6 (diagonal) or 36 (full) values.",
+              attr);
+  return std::nullopt;
+}
+
+// 计算刚体在 qpos0 下的世界位姿（沿父链复合 body_pos / body_quat）
+void BodyInitialPose(const mjModel* m, int body, mjtNum pos[3], mjtNum quat[4]) {
+  mju_zero3(pos);
+  mju_unit4(quat);
+  for (int b = body; b > 0; b = m->body_parentid[b]) {
+    mjtNum child_pos[3], child_quat[4];
+    mju_copy3(child_pos, pos);
+    mju_copy4(child_quat, quat);
+    mju_mulPose(pos, quat, m->body_pos + 3 * b, m->body_quat + 4 * b,
+                child_pos, child_quat);
+  }
+}
+
+}  // namespace
+
+// --------------------------- BushingConfig ----------------------------------
+std::optional<BushingConfig> BushingConfig::FromModel(const mjModel* m,
+                                                      int instance) {
+  BushingConfig config;
+
+  // 1) 两个刚体
+  auto body1_name = ReadStringAttr(m, instance, "body1");
+  auto body2_name = ReadStringAttr(m, instance, "body2");
+  if (!body1_name || !body2_name) {
+    mju_warning("Bushing plugin requires both 'body1' and 'body2' attributes.");
+    return std::nullopt;
+  }
+  config.body1 = FindBody(m, *body1_name);
+  config.body2 = FindBody(m, *body2_name);
+  if (config.body1 < 0 || config.body2 < 0) {
+    return std::nullopt;
+  }
+  if (config.body1 == config.body2) {
+    mju_warning("Bushing plugin: 'body1' and 'body2' must differ.");
+    return std::nullopt;
+  }
+
+  // 2) 刚度 / 阻尼矩阵
+  if (!ReadStringAttr(m, instance, "stiffness")) {
+    mju_warning("Bushing plugin requires the 'stiffness' attribute.");
+    return std::nullopt;
+  }
+  auto full_stiffness = ReadMatrix6(m, instance, "stiffness", &config.stiffness);
+  auto full_damping = ReadMatrix6(m, instance, "damping", &config.damping);
+  if (!full_stiffness || !full_damping) {
+    return std::nullopt;
+  }
+  config.full = *full_stiffness || *full_damping;
+
+  // 3) 坐标系偏移
+  struct Offset { const char* attr; mjtNum* value; int size; };
+  const Offset offsets[] = {{"pos1", config.pos1, 3}, {"quat1", config.quat1, 4},
+                            {"pos2", config.pos2, 3}, {"quat2", config.quat2, 4}};
+  bool explicit_frames = false;
+  for (const Offset& offset : offsets) {
+    auto values = ReadVectorAttr(m, instance, offset.attr);
+    if (!values) continue;
+    if (static_cast<int>(values->size()) != offset.size) {
+      mju_warning("Bushing plugin: '%s' needs %d values.", offset.attr,
+                  offset.size);
+      return std::nullopt;
+    }
+    std::copy(values->begin(), values->end(), offset.value);
+    explicit_frames = true;
+  }
+  mju_normalize4(config.quat1);
+  mju_normalize4(config.quat2);
+
+  // 未给出偏移：F1 取 body2 在 qpos0 处相对 body1 的位姿，F2 与 body2 重合
+  if (!explicit_frames) {
+    mjtNum pos1[3], quat1[4], pos2[3], quat2[4], inv_pos[3], inv_quat[4];
+    BodyInitialPose(m, config.body1, pos1, quat1);
+    BodyInitialPose(m, config.body2, pos2, quat2);
+    mju_negPose(inv_pos, inv_quat, pos1, quat1);
+    mju_mulPose(config.pos1, config.quat1, inv_pos, inv_quat, pos2, quat2);
+  }
+
+  return config;
+}
+
+// ------------------------------ Bushing -------------------------------------
+std::unique_ptr<Bushing> Bushing::Create(const mjModel* m, int instance) {
+  auto config = BushingConfig::FromModel(m, instance);
+  if (!config) {
+    return nullptr;  // 配置解析失败
+  }
+  return std::unique_ptr<Bushing>(new Bushing(m, std::move(*config)));
+}
+
+Bushing::Bushing(const mjModel* m, BushingConfig config)
+    : config_(std::move(config)),
+      chains_(m, {config_.body1, config_.body2}) {}
+
+void Bushing::FramePose(const mjData* d, int body, const mjtNum pos[3],
+                        const mjtNum quat[4], mjtNum frame_pos[3],
+                        mjtNum frame_quat[4]) {
+  mju_mulPose(frame_pos, frame_quat, d->xpos + 3 * body, d->xquat + 4 * body,
+              pos, quat);
+}
+
+// cvel 为 [角速度; 子树质心处线速度]，方向均为世界坐标系
+void Bushing::PointVelocity(const mjModel* m, const mjData* d, int body,
+                            const mjtNum point[3], mjtNum lin[3], mjtNum ang[3]) {
+  const mjtNum* cvel = d->cvel + 6 * body;
+  mjtNum offset[3], rotational[3];
+  mju_sub3(offset, point, d->subtree_com + 3 * m->body_rootid[body]);
+  mju_cross(rotational, cvel, offset);
+  mju_add3(lin, cvel + 3, rotational);
+  mju_copy3(ang, cvel);
+}
+
+void Bushing::Compute(const mjModel* m, mjData* d, int /*instance*/) {
+  const int body1 = config_.body1;
+  const int body2 = config_.body2;
+
+  // ---------- 1) 两坐标系的世界位姿 ----------
+  mjtNum p1[3], q1[4], p2[3], q2[4];
+  FramePose(d, body1, config_.pos1, config_.quat1, p1, q1);
+  FramePose(d, body2, config_.pos2, config_.quat2, p2, q2);
+  mjtNum q1_inv[4];
+  mju_negQuat(q1_inv, q1);
+
+  // ---------- 2) F1 中的位姿误差：平移 + 四元数对数映射 ----------
+  mjtNum error[6], delta[3];
+  mju_sub3(delta, p2, p1);
+  mju_rotVecQuat(error, delta, q1_inv);
+  mju_subQuat(error + 3, q2, q1);  // log(q1^-1 q2)，表示在 F1 中
+
+  // ---------- 3) F1 中的速度误差 ----------
+  // body1 上与 p2 重合点的速度，使平移部分恰为 e_t 的时间导数
+  mjtNum v1[3], w1[3], v2[3], w2[3], error_dot[6];
+  PointVelocity(m, d, body1, p2, v1, w1);
+  PointVelocity(m, d, body2, p2, v2, w2);
+  mju_sub3(delta, v2, v1);
+  mju_rotVecQuat(error_dot, delta, q1_inv);
+  mju_sub3(delta, w2, w1);
+  mju_rotVecQuat(error_dot + 3, delta, q1_inv);
+
+  // ---------- 4) 力旋量 w = -(K e + C e_dot) ----------
+  mjtNum wrench[6];
+  if (config_.full) {
+    mjtNum elastic[6], viscous[6];
+    mju_mulMatVec(elastic, config_.stiffness.data(), error, 6, 6);
+    mju_mulMatVec(viscous, config_.damping.data(), error_dot, 6, 6);
+    for (int k = 0; k < 6; ++k) wrench[k] = -(elastic[k] + viscous[k]);
+  } else {
+    for (int k = 0; k < 6; ++k) {
+      wrench[k] = -(config_.stiffness[7 * k] * error[k] +
+                    config_.damping[7 * k] * error_dot[k]);
+    }
+  }
+
+  // ---------- 5) 转回世界坐标系，作用于 p2，经稀疏 J^T 累加 ----------
+  mjtNum force[3], torque[3];
+  mju_rotVecQuat(force, wrench, q1);
+  mju_rotVecQuat(torque, wrench + 3, q1);
+  chains_.AddForceTorque(m, d, body2, force, torque, p2, d->qfrc_passive);
+  mju_scl3(force, force, -1);
+  mju_scl3(torque, torque, -1);
+  chains_.AddForceTorque(m, d, body1, force, torque, p2, d->qfrc_passive);
+}
+
+// --------------------------- 插件注册 ---------------------------------------
+void Bushing::RegisterPlugin() {
+  mjpPlugin plugin;
+  mjp_defaultPlugin(&plugin);
+
+  plugin.name = "mujoco.passive.bushing";
+  plugin.capabilityflags |= mjPLUGIN_PASSIVE;
+
+  static const char* attributes[] = {"body1", "body2", "stiffness", "damping",
+                                     "pos1", "quat1", "pos2", "quat2"};
+  plugin.nattribute = sizeof(attributes) / sizeof(attributes[0]);
+  plugin.attributes = attributes;
+
+  plugin.nstate = +[](const mjModel*, int) { return 0; };
+
+  plugin.init = +[](const mjModel* m, mjData* d, int instance) {
+    auto bushing = Bushing::Create(m, instance);
+    if (!bushing) return -1;
+    d->plugin_data[instance] = reinterpret_cast<uintptr_t>(bushing.release());
+    return 0;
+  };
+
+  plugin.destroy = +[](mjData* d, int instance) {
+    delete reinterpret_cast<Bushing*>(d->plugin_data[instance]);
+    d->plugin_data[instance] = 0;
+  };
+
+  plugin.compute = +[](const mjModel* m, mjData* d, int instance, int /*stage*/) {
+    reinterpret_cast<Bushing*>(d->plugin_data[instance])->Compute(m, d, instance);
+  };
+
+  mjp_registerPlugin(&plugin);
+}
+
+}  // namespace mujoco::plugin::passive
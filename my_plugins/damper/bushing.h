@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_BUSHING_H_
+#define MUJOCO_PLUGIN_PASSIVE_BUSHING_H_
+
+#include <array>
+#include <memory>
+#include <optional>
+
+#include <mujoco/mujoco.h>
+
+#include "body_chain.h"
+
+namespace mujoco::plugin::passive {
+
+// Configuration for the bushing plugin
+struct BushingConfig {
+  int body1 = -1;
+  int body2 = -1;
+
+  // 6x6 stiffness and damping, row-major, acting on [translation; rotation]
+  // errors expressed in the frame attached to body1.
+  std::array<mjtNum, 36> stiffness{};
+  std::array<mjtNum, 36> damping{};
+  bool full = false;            // false if both matrices are diagonal
+
+  // Frame offsets in the local frames of body1 and body2. If none is given,
+  // both frames sit at body2's qpos0 pose so the bushing starts unloaded.
+  mjtNum pos1[3] = {0, 0, 0};
+  mjtNum quat1[4] = {1, 0, 0, 0};
+  mjtNum pos2[3] = {0, 0, 0};
+  mjtNum quat2[4] = {1, 0, 0, 0};
+
+  // Factory function to create a BushingConfig from the MuJoCo model
+  static std::optional<BushingConfig> FromModel(const mjModel* m, int instance);
+};
+
+// A six-DoF spring-damper between two body frames. Compliance is applied as a
+// passive wrench, so unlike a weld equality it adds no constraint rows.
+class Bushing {
+ public:
+  static std::unique_ptr<Bushing> Create(const mjModel* m, int instance);
+
+  // Computes the bushing wrench and adds it to d->qfrc_passive.
+  void Compute(const mjModel* m, mjData* d, int instance);
+
+  static void RegisterPlugin();
+
+ private:
+  Bushing(const mjModel* m, BushingConfig config);
+
+  // World pose of the frame with local offset (pos, quat) on `body`.
+  static void FramePose(const mjData* d, int body, const mjtNum pos[3],
+                        const mjtNum quat[4], mjtNum frame_pos[3],
+                        mjtNum frame_quat[4]);
+
+  // World velocity of the point `point` on `body` and the body's angular velocity.
+  static void PointVelocity(const mjModel* m, const mjData* d, int body,
+                            const mjtNum point[3], mjtNum lin[3], mjtNum ang[3]);
+
+  BushingConfig config_;
+  BodyChains chains_;
+};
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_BUSHING_H_
@@ -0,0 +1,31 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_GLOB_MATCH_H_
+#define MUJOCO_PLUGIN_PASSIVE_GLOB_MATCH_H_
+
+#include <string>
+
+namespace mujoco::plugin::passive {
+
+// Matches `name` against `pattern`: '*' matches any run of characters and
+// '?' matches a single character.
+bool GlobMatch(const char* pattern, const char* name);
+
+// Returns true if `s` contains '*' or '?'.
+bool HasWildcard(const std::string& s);
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_GLOB_MATCH_H_
@@ -0,0 +1,432 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：proximity_spring.cc
+//  说明：
+//    “吸附 / 磁吸”式的动态弹簧 PASSIVE 插件：被标记的刚体之间距离小于
+//    capture 时自动建立弹簧，超过 release 时断开。
+//    宽相位使用均匀空间哈希（格子边长 = capture），每步只把跨格移动的刚体
+//    重新挂到新桶中，查找候选对只需扫描相邻 27 个格子，复杂度 O(n)。
+//    活动弹簧存放在固定容量的槽位池中，一根弹簧在存续期间槽位不变；
+//    新弹簧优先占用最小的空闲槽位，使占用区间保持紧凑，力计算直接复用
+//    弹簧插件的向量化核函数，在 [0, end) 上运行。
+//
+//    支持的 XML 属性：
+//      • bodies      : 刚体名称通配模式，匹配到的刚体之间可以相互吸附
+//      • capture     : 建立连接的距离阈值 (m)
+//      • release     : 断开连接的距离阈值 (m)，不小于 capture
+//      • stiffness   : 弹簧刚度 k (N/m)
+//      • damping     : 阻尼系数 d (N·s/m)
+//      • restlength  : 自然长度，负值表示取建立连接时的距离
+//      • maxlinks    : 槽位池容量，缺省为每个被标记刚体 4 根
+//      • simd        : 力核函数指令集，同弹簧插件
+//
+// -----------------------------------------------------------------------------
+
+#include "proximity_spring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+#include "glob_match.h"
+
+namespace mujoco::plugin::passive {
+namespace {  // 匿名命名空间，限制辅助函数作用域
+
+// 从插件配置读取 double 类型，可缺省
+std::optional<mjtNum> ReadOptionalDoubleAttr(const mjModel* m, int instance,
+                                             const char* attr) {
+  const char* value = mj_getPluginConfig(m, instance, attr);
+  if (value == nullptr || value[0] == '\0') {
+    return std::nullopt;  // 未提供该属性
+  }
+  return std::strtod(value, nullptr);
+}
+
+// 从插件配置读取 string 类型，可缺省
+std::optional<std::string> ReadStringAttr(const mjModel* m, int instance,
+                                          const char* attr) {
+  const char* value = mj_getPluginConfig(m, instance, attr);
+  if (value == nullptr || value[0] == '\0') {
+    return std::nullopt;  // 未提供
+  }
+  return std::string(value);
+}
+
+}  // namespace
+
+// -------------------------- ProximitySpringConfig ---------------------------
+std::optional<ProximitySpringConfig> ProximitySpringConfig::FromModel(
+    const mjModel* m, int instance) {
+  ProximitySpringConfig config;
+
+  // 1) 被标记的刚体
+  auto pattern = ReadStringAttr(m, instance, "bodies");
+  if (!pattern) {
+    mju_warning("Proximity spring plugin requires the 'bodies' attribute.");
+    return std::nullopt;
+  }
+  for (int b = 1; b < m->nbody; ++b) {
+    const char* name = mj_id2name(m, mjOBJ_BODY, b);
+    if (name && GlobMatch(pattern->c_str(), name)) {
+      config.bodies.push_back(b);
+    }
+  }
+  if (config.bodies.size() < 2) {
+    mju_warning("Proximity spring plugin: pattern '%s' matched fewer than two "
+                "bodies.", pattern->c_str());
+    return std::nullopt;
+  }
+
+  // 2) 距离阈值
+  config.capture = ReadOptionalDoubleAttr(m, instance, "capture").value_or(config.capture);
+  config.release = ReadOptionalDoubleAttr(m, instance, "release").value_or(
+      std::max(config.release, config.capture));
+  if (!(config.capture > 0) || config.release < config.capture) {
+    mju_warning("Proximity spring plugin: need 0 < capture <= release.");
+    return std::nullopt;
+  }
+
+  // 3) 弹簧参数
+  config.stiffness   = ReadOptionalDoubleAttr(m, instance, "stiffness").value_or(config.stiffness);
+  config.damping     = ReadOptionalDoubleAttr(m, instance, "damping").value_or(config.damping);
+  config.rest_length = ReadOptionalDoubleAttr(m, instance, "restlength").value_or(-1.0);
+
+  // 4) 槽位池容量
+  config.max_links = static_cast<int>(
+      ReadOptionalDoubleAttr(m, instance, "maxlinks").value_or(0));
+  if (config.max_links <= 0) {
+    config.max_links = 4 * static_cast<int>(config.bodies.size());
+  }
+
+  // 5) 核函数指令集
+  config.simd = ReadStringAttr(m, instance, "simd").value_or("auto");
+  if (config.simd != "auto" && !ParseSpringIsa(config.simd)) {
+    mju_warning("Proximity spring plugin: unknown simd '%s', using auto.",
+                config.simd.c_str());
+    config.simd = "auto";
+  }
+
+  return config;
+}
+
+// ------------------------------ SpatialHash ---------------------------------
+SpatialHash::SpatialHash(int nitem, double cell_size)
+    : inv_cell_(1 / cell_size),
+      next_(nitem, -1),
+      prev_(nitem, -1),
+      bucket_(nitem, -1),
+      cell_(3 * nitem, 0) {
+  int nbucket = 1;
+  while (nbucket < 2 * nitem) nbucket *= 2;  // 桶数取 2 的幂，负载因子 <= 0.5
+  mask_ = nbucket - 1;
+  head_.assign(nbucket, -1);
+}
+
+std::int64_t SpatialHash::CellCoord(mjtNum x) const {
+  // 远离原点或非有限值的坐标统一夹到边界格子，避免整数溢出
+  constexpr mjtNum kLimit = 1e15;
+  mjtNum c = std::floor(x * inv_cell_);
+  if (!(c > -kLimit)) c = -kLimit;
+  if (c > kLimit) c = kLimit;
+  return static_cast<std::int64_t>(c);
+}
+
+int SpatialHash::Bucket(std::int64_t ix, std::int64_t iy, std::int64_t iz) const {
+  std::uint64_t h = static_cast<std::uint64_t>(ix) * 73856093u ^
+                    static_cast<std::uint64_t>(iy) * 19349663u ^
+                    static_cast<std::uint64_t>(iz) * 83492791u;
+  return static_cast<int>(h & static_cast<std::uint64_t>(mask_));
+}
+
+void SpatialHash::Unlink(int k) {
+  if (bucket_[k] < 0) return;
+  if (prev_[k] >= 0) {
+    next_[prev_[k]] = next_[k];
+  } else {
+    head_[bucket_[k]] = next_[k];
+  }
+  if (next_[k] >= 0) prev_[next_[k]] = prev_[k];
+  next_[k] = prev_[k] = bucket_[k] = -1;
+}
+
+// 增量更新：只有跨格移动的条目才会从旧桶摘下、挂到新桶
+void SpatialHash::Update(int k, const mjtNum pos[3]) {
+  std::int64_t cell[3] = {CellCoord(pos[0]), CellCoord(pos[1]),
+                          CellCoord(pos[2])};
+  std::int64_t* stored = cell_.data() + 3 * k;
+  if (bucket_[k] >= 0 && cell[0] == stored[0] && cell[1] == stored[1] &&
+      cell[2] == stored[2]) {
+    return;
+  }
+  Unlink(k);
+  stored[0] = cell[0];
+  stored[1] = cell[1];
+  stored[2] = cell[2];
+  int bucket = Bucket(cell[0], cell[1], cell[2]);
+  bucket_[k] = bucket;
+  next_[k] = head_[bucket];
+  if (next_[k] >= 0) prev_[next_[k]] = k;
+  head_[bucket] = k;
+}
+
+void SpatialHash::Clear() {
+  std::fill(head_.begin(), head_.end(), -1);
+  std::fill(next_.begin(), next_.end(), -1);
+  std::fill(prev_.begin(), prev_.end(), -1);
+  std::fill(bucket_.begin(), bucket_.end(), -1);
+}
+
+// ----------------------------- ProximitySpring ------------------------------
+std::unique_ptr<ProximitySpring> ProximitySpring::Create(const mjModel* m,
+                                                         mjData* d,
+                                                         int instance) {
+  auto config = ProximitySpringConfig::FromModel(m, instance);
+  if (!config) {
+    return nullptr;  // 配置解析失败
+  }
+  return std::unique_ptr<ProximitySpring>(
+      new ProximitySpring(m, d, instance, std::move(*config)));
+}
+
+ProximitySpring::ProximitySpring(const mjModel* m, const mjData* d,
+                                 int instance, ProximitySpringConfig config)
+    : config_(std::move(config)),
+      data_(d),
+      instance_(instance),
+      hash_(static_cast<int>(config_.bodies.size()), config_.capture) {
+  velocity_cache_ = BodyVelocityCache::Acquire(m, d, instance, config_.bodies);
+  chains_ = BodyChains(m, config_.bodies);
+
+  // 槽位池一次性分配，空槽位系数为零、两端指向 world，核函数可直接跑过
+  const int capacity = config_.max_links;
+  active_.assign(capacity, 0);
+  body1_.assign(capacity, 0);
+  body2_.assign(capacity, 0);
+  adr1_.assign(capacity, 0);
+  adr2_.assign(capacity, 0);
+  stiffness_.assign(capacity, 0);
+  damping_.assign(capacity, 0);
+  rest_length_.assign(capacity, 0);
+  dir_x_.resize(capacity);
+  dir_y_.resize(capacity);
+  dir_z_.resize(capacity);
+  length_.resize(capacity);
+  rate_.resize(capacity);
+  force_.resize(capacity);
+  linked_.reserve(2 * capacity);
+
+  SpringIsa isa = DetectSpringIsa();
+  if (auto requested = ParseSpringIsa(config_.simd)) {
+    if (SpringIsaSupported(*requested)) isa = *requested;
+  }
+  kernel_ = GetSpringKernel(isa, SpringLaw::kLinear, config_.stiffness != 0,
+                            config_.damping != 0);
+
+  args_.adr1 = adr1_.data();
+  args_.adr2 = adr2_.data();
+  args_.stiffness = stiffness_.data();
+  args_.damping = damping_.data();
+  args_.rest_length = rest_length_.data();
+  args_.dir_x = dir_x_.data();
+  args_.dir_y = dir_y_.data();
+  args_.dir_z = dir_z_.data();
+  args_.length = length_.data();
+  args_.rate = rate_.data();
+  args_.force = force_.data();
+}
+
+ProximitySpring::~ProximitySpring() {
+  BodyVelocityCache::Release(data_, instance_);
+}
+
+std::uint64_t ProximitySpring::PairKey(int body1, int body2) {
+  if (body1 > body2) std::swap(body1, body2);
+  return static_cast<std::uint64_t>(body1) << 32 |
+         static_cast<std::uint32_t>(body2);
+}
+
+// 占用最小的空闲槽位；没有可用的空闲槽位时在 end_ 处追加
+void ProximitySpring::AddLink(const mjData* d, int body1, int body2) {
+  int slot = -1;
+  while (!free_.empty()) {
+    int candidate = free_.top();
+    free_.pop();
+    if (candidate < end_ && !active_[candidate]) {
+      slot = candidate;
+      break;
+    }
+  }
+  if (slot < 0) {
+    if (end_ == config_.max_links) {  // 槽位池已满
+      if (!pool_full_warned_) {
+        mju_warning("Proximity spring plugin: link pool full (%d), raise "
+                    "'maxlinks'.", config_.max_links);
+        pool_full_warned_ = true;
+      }
+      return;
+    }
+    slot = end_++;
+  }
+
+  active_[slot] = 1;
+  body1_[slot] = body1;
+  body2_[slot] = body2;
+  adr1_[slot] = 3 * body1;
+  adr2_[slot] = 3 * body2;
+  stiffness_[slot] = config_.stiffness;
+  damping_[slot] = config_.damping;
+  rest_length_[slot] = config_.rest_length >= 0
+      ? config_.rest_length
+      : mju_dist3(d->xpos + 3 * body1, d->xpos + 3 * body2);
+  linked_.insert(PairKey(body1, body2));
+  ++nlink_;
+}
+
+// 释放槽位并清零系数；末尾的空槽位直接收缩 end_
+void ProximitySpring::RemoveLink(int slot) {
+  linked_.erase(PairKey(body1_[slot], body2_[slot]));
+  active_[slot] = 0;
+  body1_[slot] = body2_[slot] = 0;
+  adr1_[slot] = adr2_[slot] = 0;
+  stiffness_[slot] = damping_[slot] = rest_length_[slot] = 0;
+  --nlink_;
+  free_.push(slot);
+  while (end_ > 0 && !active_[end_ - 1]) --end_;
+}
+
+void ProximitySpring::Release(const mjData* d) {
+  const mjtNum release2 = config_.release * config_.release;
+  for (int slot = 0; slot < end_; ++slot) {
+    if (!active_[slot]) continue;
+    mjtNum delta[3];
+    mju_sub3(delta, d->xpos + adr2_[slot], d->xpos + adr1_[slot]);
+    if (mju_dot3(delta, delta) > release2) {
+      RemoveLink(slot);
+    }
+  }
+}
+
+void ProximitySpring::Capture(const mjData* d) {
+  const int n = static_cast<int>(config_.bodies.size());
+  for (int k = 0; k < n; ++k) {
+    hash_.Update(k, d->xpos + 3 * config_.bodies[k]);
+  }
+
+  const mjtNum capture2 = config_.capture * config_.capture;
+  for (int k = 0; k < n; ++k) {
+    const int body = config_.bodies[k];
+    const mjtNum* pos = d->xpos + 3 * body;
+    hash_.ForEachNear(pos, [&](int j) {
+      if (j <= k) return;  // 每对只检查一次
+      const int other = config_.bodies[j];
+      mjtNum delta[3];
+      mju_sub3(delta, d->xpos + 3 * other, pos);
+      if (mju_dot3(delta, delta) >= capture2) return;
+      if (linked_.count(PairKey(body, other))) return;
+      AddLink(d, body, other);
+    });
+  }
+}
+
+void ProximitySpring::Reset() {
+  for (int slot = 0; slot < end_; ++slot) {
+    if (active_[slot]) RemoveLink(slot);
+  }
+  free_ = {};
+  end_ = 0;
+  hash_.Clear();
+}
+
+void ProximitySpring::Compute(const mjModel* m, mjData* d, int /*instance*/) {
+  // ---------- 1) 断开过长的连接，再由空间哈希建立新连接 ----------
+  Release(d);
+  Capture(d);
+
+  // 速度缓存必须每步更新（见 body_velocity_cache.h），即使没有连接
+  args_.body_vel = velocity_cache_->Update(d, instance_);
+  if (!nlink_) return;
+
+  // ---------- 2) 在占用区间上运行弹簧核函数 ----------
+  args_.xpos = d->xpos;
+  kernel_(args_, 0, end_);
+
+  // ---------- 3) 活动连接的力经稀疏 J^T 累加到 qfrc_passive ----------
+  for (int slot = 0; slot < end_; ++slot) {
+    if (!active_[slot]) continue;
+    mjtNum force_vec[3] = {dir_x_[slot] * force_[slot],
+                           dir_y_[slot] * force_[slot],
+                           dir_z_[slot] * force_[slot]};
+    chains_.AddForce(m, d, body1_[slot], force_vec, d->xpos + adr1_[slot],
+                     d->qfrc_passive);
+    mju_scl3(force_vec, force_vec, -1);
+    chains_.AddForce(m, d, body2_[slot], force_vec, d->xpos + adr2_[slot],
+                     d->qfrc_passive);
+  }
+}
+
+// --------------------------- 插件注册 ---------------------------------------
+void ProximitySpring::RegisterPlugin() {
+  mjpPlugin plugin;
+  mjp_defaultPlugin(&plugin);
+
+  plugin.name = "mujoco.passive.proximity_spring";
+  plugin.capabilityflags |= mjPLUGIN_PASSIVE;
+
+  static const char* attributes[] = {"bodies", "capture", "release",
+                                     "stiffness", "damping", "restlength",
+                                     "maxlinks", "simd"};
+  plugin.nattribute = sizeof(attributes) / sizeof(attributes[0]);
+  plugin.attributes = attributes;
+
+  plugin.nstate = +[](const mjModel*, int) { return 0; };
+
+  plugin.init = +[](const mjModel* m, mjData* d, int instance) {
+    auto spring = ProximitySpring::Create(m, d, instance);
+    if (!spring) return -1;
+    d->plugin_data[instance] = reinterpret_cast<uintptr_t>(spring.release());
+    return 0;
+  };
+
+  plugin.destroy = +[](mjData* d, int instance) {
+    delete reinterpret_cast<ProximitySpring*>(d->plugin_data[instance]);
+    d->plugin_data[instance] = 0;
+  };
+
+  // reset：mj_resetData 时断开所有连接（init 之前 plugin_data 为空）
+  plugin.reset = +[](const mjModel*, mjtNum*, void* plugin_data, int) {
+    if (plugin_data) {
+      static_cast<ProximitySpring*>(plugin_data)->Reset();
+    }
+  };
+
+  plugin.compute = +[](const mjModel* m, mjData* d, int instance, int /*stage*/) {
+    reinterpret_cast<ProximitySpring*>(d->plugin_data[instance])
+        ->Compute(m, d, instance);
+  };
+
+  mjp_registerPlugin(&plugin);
+}
+
+}  // namespace mujoco::plugin::passive
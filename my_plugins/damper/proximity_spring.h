@@ -0,0 +1,160 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_PROXIMITY_SPRING_H_
+#define MUJOCO_PLUGIN_PASSIVE_PROXIMITY_SPRING_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <mujoco/mujoco.h>
+
+#include "body_chain.h"
+#include "body_velocity_cache.h"
+#include "spring_kernel.h"
+
+namespace mujoco::plugin::passive {
+
+// Configuration for the proximity spring plugin
+struct ProximitySpringConfig {
+  std::vector<int> bodies;      // Tagged bodies that may link to each other
+  double capture = 0.05;        // Links form below this distance
+  double release = 0.1;         // and break above this one (>= capture)
+  double stiffness = 100.0;
+  double damping = 1.0;
+  double rest_length = -1.0;    // Negative: the distance at capture
+  int max_links = 0;            // Link pool capacity, 0 means 4 per tagged body
+  std::string simd = "auto";
+
+  static std::optional<ProximitySpringConfig> FromModel(const mjModel* m,
+                                                        int instance);
+};
+
+// Uniform spatial hash over body positions. Each body stays in its bucket
+// until it moves to another cell, so an update only relinks moving bodies.
+class SpatialHash {
+ public:
+  SpatialHash() = default;
+  SpatialHash(int nitem, double cell_size);
+
+  // Moves item k to the cell containing pos if it changed.
+  void Update(int k, const mjtNum pos[3]);
+
+  // Calls visit(j) for every item in the 27 cells around pos. Items of other
+  // cells that share a bucket are visited too, possibly more than once;
+  // callers check distances.
+  template <class Visit>
+  void ForEachNear(const mjtNum pos[3], Visit visit) const {
+    const std::int64_t cx = CellCoord(pos[0]);
+    const std::int64_t cy = CellCoord(pos[1]);
+    const std::int64_t cz = CellCoord(pos[2]);
+    for (std::int64_t ix = cx - 1; ix <= cx + 1; ++ix) {
+      for (std::int64_t iy = cy - 1; iy <= cy + 1; ++iy) {
+        for (std::int64_t iz = cz - 1; iz <= cz + 1; ++iz) {
+          for (int j = head_[Bucket(ix, iy, iz)]; j >= 0; j = next_[j]) {
+            visit(j);
+          }
+        }
+      }
+    }
+  }
+
+  // Removes every item.
+  void Clear();
+
+ private:
+  std::int64_t CellCoord(mjtNum x) const;
+  int Bucket(std::int64_t ix, std::int64_t iy, std::int64_t iz) const;
+  void Unlink(int k);
+
+  double inv_cell_ = 1;
+  int mask_ = 0;                     // number of buckets - 1 (power of two)
+  std::vector<int> head_;            // first item of each bucket, -1 if empty
+  std::vector<int> next_, prev_;     // doubly linked bucket lists
+  std::vector<int> bucket_;          // bucket of each item, -1 if not inserted
+  std::vector<std::int64_t> cell_;   // 3 cell coordinates per item
+};
+
+// Springs that form between tagged bodies closer than a capture radius and
+// break beyond a release radius. Links live in a pool whose slots are stable
+// for the lifetime of a link; the force kernel of the spring plugin runs over
+// the occupied prefix of the pool.
+class ProximitySpring {
+ public:
+  static std::unique_ptr<ProximitySpring> Create(const mjModel* m, mjData* d,
+                                                 int instance);
+  ~ProximitySpring();
+
+  void Compute(const mjModel* m, mjData* d, int instance);
+
+  // Breaks every link.
+  void Reset();
+
+  // Number of active links.
+  int nlink() const { return nlink_; }
+
+  static void RegisterPlugin();
+
+ private:
+  ProximitySpring(const mjModel* m, const mjData* d, int instance,
+                  ProximitySpringConfig config);
+
+  // Forms links between tagged bodies within the capture radius.
+  void Capture(const mjData* d);
+
+  // Breaks links longer than the release radius.
+  void Release(const mjData* d);
+
+  void AddLink(const mjData* d, int body1, int body2);
+  void RemoveLink(int slot);
+
+  static std::uint64_t PairKey(int body1, int body2);
+
+  ProximitySpringConfig config_;
+  const mjData* data_;
+  int instance_;
+
+  SpatialHash hash_;
+  std::unordered_set<std::uint64_t> linked_;   // PairKey of active links
+
+  // Link pool, indexed by slot. Free slots have zero coefficients and point
+  // at the world body, so the kernel can run over them harmlessly.
+  std::vector<unsigned char> active_;
+  std::vector<int> body1_, body2_;
+  std::vector<int> adr1_, adr2_;
+  std::vector<mjtNum> stiffness_, damping_, rest_length_;
+  std::vector<mjtNum> dir_x_, dir_y_, dir_z_;
+  std::vector<mjtNum> length_, rate_, force_;
+  // Freed slots, smallest first so the pool stays compact. Entries may be
+  // stale (reoccupied or beyond end_) and are validated when popped.
+  std::priority_queue<int, std::vector<int>, std::greater<int>> free_;
+  int end_ = 0;                        // one past the highest occupied slot
+  int nlink_ = 0;
+  bool pool_full_warned_ = false;
+
+  BodyVelocityCache* velocity_cache_ = nullptr;
+  BodyChains chains_;
+  SpringKernelFn kernel_ = nullptr;
+  SpringKernelArgs args_;
+};
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_PROXIMITY_SPRING_H_
@@ -13,10 +13,16 @@
 // limitations under the License.
 
 #include <mujoco/mjplugin.h>
+#include "bushing.h"
+#include "proximity_spring.h"
 #include "spring_damper.h"
 
 namespace mujoco::plugin::passive {
 
-mjPLUGIN_LIB_INIT { Spring::RegisterPlugin(); }
+mjPLUGIN_LIB_INIT {
+  Spring::RegisterPlugin();
+  Bushing::RegisterPlugin();
+  ProximitySpring::RegisterPlugin();
+}
 
 }  // namespace mujoco::plugin::passive
\ No newline at end of file
@@ -19,27 +19,78 @@
 //    这是一个 MuJoCo PASSIVE 插件示例，实现了最经典的“弹簧-阻尼器”模型。
 //    插件通过在两个刚体之间施加方向相反且大小相等的力来模拟弹簧拉力，
 //    同时叠加速度相关的阻尼力。可在 XML 中通过 <plugin> 标签进行参数化。
+//    力作用在刚体坐标原点 (xpos)，经缓存的稀疏雅可比 J^T f 直接累加到
+//    qfrc_passive，不会修改用户输入 xfrc_applied。
+//    初始化时按 DOF 冲突对弹簧做图着色，同色弹簧互不共享 DOF；若 mjData
+//    绑定了线程池，大的颜色类会被拆分到各工作线程上无锁并行计算。
+//
+//    刚度、阻尼与自然长度保存在 plugin_state 中（各 n 个，按声明顺序），
+//    可通过 mj_setState / mj_getState 在不重新编译模型的情况下修改或快照，
+//    compute 时若发现与上次不同则重新计算核函数系数；reset 恢复 XML 配置值。
+//
+//    插件同时声明 SENSOR 能力：在 <sensor><plugin instance="..."/></sensor>
+//    中引用后，每根弹簧按声明顺序输出 [伸长量, 伸长率, 拉力] 三个值，直接取自
+//    核函数结果（隐式模式下拉力为未经隐式修正的物理力）；开启 energy 标志时
+//    弹性势能累加到 d->energy[0]。
+//
+//    一个插件实例可以管理任意多根弹簧：所有弹簧的参数与刚体索引以
+//    结构体数组 (SoA) 形式连续存放，并在一次 compute 回调中统一计算，
+//    避免大规模弹簧网络中逐实例回调与指针跳转的开销。
 //
 //    支持的 XML 属性：
 //      • stiffness   : 弹簧刚度系数 k (单位 N/m)
 //      • damping     : 阻尼系数 d (单位 N·s/m)
 //      • restlength  : 弹簧自然长度 (负值表示使用模型初始距离)
-//      • body1 / body2: 参与作用的两个刚体名称
+//      • body1 / body2: 参与作用的两个刚体名称（单根弹簧）
+//      • pairs       : 以空白分隔的 "a:b" 列表，每项声明一根弹簧；
+//                      a 中可含通配符 '*' / '?'，若 b 中含 '*'，
+//                      则用 a 中 '*' 匹配到的文本替换，例如
+//                      "node_*_l:node_*_r"
+//      • chain       : 刚体名称通配模式，按刚体 ID 顺序依次首尾相连
+//      • simd        : 力核函数指令集 auto(默认)/scalar/sse2/avx2/avx512，
+//                      scalar 为位级一致的参考实现
+//      • implicit    : true/false(默认)，是否对弹簧力做逐弹簧的隐式修正
+//                      （近似：弹簧被软化为 α k，承载时的静态伸长随步长
+//                      增大为 1/α 倍，见 spring_damper.h 与
+//                      UpdateCoefficients）
+//      • law         : 力学模型 linear(默认)/cable(只受拉)/cubic/table，
+//                      初始化时选定，对应编译期特化的核函数
+//      • cubic       : cubic 模型的三次项系数 k3，F = k x + k3 x^3 + d v
+//      • table       : table 模型的 "伸长量 力" 数据点，按伸长量递增排列；
+//                      此时 stiffness 为表的缩放系数（缺省 1）
+//      • tablesize   : 查表网格点数（缺省 64），插值不做搜索
+//      • interp      : 查表插值方式 linear(默认)/cubic
+//      • sleep       : true/false(默认)，是否跳过静止的弹簧：两端速度低于
+//                      sleepvel 且每 sleepinterval 步检查一次的长度变化低于
+//                      sleepstretch 时冻结其最后的力（小于 sleepforce 则直接
+//                      丢弃），任一端速度超过阈值即唤醒
+//      • sleepvel / sleepstretch / sleepforce / sleepinterval : 上述阈值
+//      • visualize   : true(默认)/false，是否在 mjvScene 中绘制弹簧
+//      • viswidth    : 胶囊体半径 (m)
+//      • vislod      : 弹簧数超过该值时改用细线绘制（缺省 2000）
+//      • vismaxgeom  : 最多输出的几何体数（缺省 5000），超出时均匀抽稀
+//      • visstrain   : 颜色饱和时的应变（缺省 0.1），拉伸为红、压缩为蓝
 //
 // -----------------------------------------------------------------------------
 
 #include "spring_damper.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <mujoco/mujoco.h>
 
+#include "glob_match.h"
+
 namespace mujoco::plugin::passive {
 namespace {  // 匿名命名空间，限制辅助函数作用域
 
@@ -67,6 +118,144 @@ std::optional<std::string> ReadStringAttr(const mjModel* m, int instance,
   return std::string(value);
 }
 
+// 按名称解析刚体 ID，失败时给出警告
+int FindBody(const mjModel* m, const std::string& name) {
+  int id = mj_name2id(m, mjOBJ_BODY, name.c_str());
+  if (id < 0) {
+    mju_warning("Spring plugin: could not find body '%s'.", name.c_str());
+  }
+  return id;
+}
+
+// 解析 pairs 中的一项 "a:b"，将得到的刚体对追加到 pairs
+bool ParsePairToken(const mjModel* m, const std::string& token,
+                    std::vector<std::pair<int, int>>* pairs) {
+  std::size_t colon = token.find(':');
+  if (colon == std::string::npos || colon == 0 || colon + 1 == token.size()) {
+    mju_warning("Spring plugin: malformed pair '%s', expected 'a:b'.",
+                token.c_str());
+    return false;
+  }
+  std::string first = token.substr(0, colon);
+  std::string second = token.substr(colon + 1);
+
+  // 1) 无通配符：直接按名称查找
+  if (!HasWildcard(first)) {
+    int id1 = FindBody(m, first);
+    int id2 = FindBody(m, second);
+    if (id1 < 0 || id2 < 0) return false;
+    pairs->emplace_back(id1, id2);
+    return true;
+  }
+
+  // 2) 通配模式：若 second 中含 '*'，则要求 first 中恰有一个 '*' 且无 '?'，
+  //    并用其捕获的文本替换 second 中的 '*'
+  bool substitute = second.find('*') != std::string::npos;
+  std::size_t star = first.find('*');
+  if (substitute && (star == std::string::npos ||
+                     first.find('*', star + 1) != std::string::npos ||
+                     first.find('?') != std::string::npos)) {
+    mju_warning("Spring plugin: pattern '%s' needs exactly one '*' to "
+                "substitute into '%s'.", first.c_str(), second.c_str());
+    return false;
+  }
+  int fixed_id = -1;
+  if (!substitute) {
+    fixed_id = FindBody(m, second);
+    if (fixed_id < 0) return false;
+  }
+
+  int matched = 0;
+  for (int b = 0; b < m->nbody; ++b) {
+    const char* name = mj_id2name(m, mjOBJ_BODY, b);
+    if (!name || !GlobMatch(first.c_str(), name)) continue;
+    int other = fixed_id;
+    if (substitute) {
+      std::string n(name);
+      std::string capture =
+          n.substr(star, n.size() - (first.size() - 1));  // '*' 匹配到的部分
+      std::string target = second;
+      target.replace(target.find('*'), 1, capture);
+      other = mj_name2id(m, mjOBJ_BODY, target.c_str());
+      if (other < 0) continue;  // 未形成配对的刚体直接跳过
+    }
+    if (other == b) continue;
+    pairs->emplace_back(b, other);
+    ++matched;
+  }
+  if (matched == 0) {
+    mju_warning("Spring plugin: pattern '%s' matched no body pairs.",
+                token.c_str());
+  }
+  return true;
+}
+
+// 计算刚体在 qpos0 下的世界坐标（沿父链累加 body_pos / body_quat）
+void BodyInitialPosition(const mjModel* m, int body, mjtNum pos[3]) {
+  mju_copy3(pos, m->body_pos + 3 * body);
+  for (int b = m->body_parentid[body]; b > 0; b = m->body_parentid[b]) {
+    mjtNum rotated[3];
+    mju_rotVecQuat(rotated, pos, m->body_quat + 4 * b);
+    mju_add3(pos, rotated, m->body_pos + 3 * b);
+  }
+}
+
+// 在测量数据点 (x0 f0 x1 f1 ...) 上取值：区间内线性或三次 Hermite 插值
+// （切线取相邻割线斜率的平均），区间外按端点割线斜率外推
+mjtNum EvaluateMeasured(const std::vector<double>& table, mjtNum x, bool cubic) {
+  const int npoint = static_cast<int>(table.size()) / 2;
+  auto px = [&](int j) { return table[2 * j]; };
+  auto pf = [&](int j) { return table[2 * j + 1]; };
+  auto secant = [&](int j) { return (pf(j + 1) - pf(j)) / (px(j + 1) - px(j)); };
+
+  int k = 0;
+  while (k + 2 < npoint && x >= px(k + 1)) ++k;
+  mjtNum width = px(k + 1) - px(k);
+  mjtNum t = (x - px(k)) / width;
+  if (!cubic || t < 0 || t > 1) {
+    return pf(k) + t * (pf(k + 1) - pf(k));
+  }
+  mjtNum m0 = k > 0 ? 0.5 * (secant(k - 1) + secant(k)) : secant(k);
+  mjtNum m1 = k + 2 < npoint ? 0.5 * (secant(k) + secant(k + 1)) : secant(k);
+  mjtNum t2 = t * t, t3 = t2 * t;
+  return (2*t3 - 3*t2 + 1) * pf(k) + (t3 - 2*t2 + t) * width * m0 +
+         (-2*t3 + 3*t2) * pf(k + 1) + (t3 - t2) * width * m1;
+}
+
+// 同色类的最大数量；超出的弹簧归入最后一个串行计算的类
+constexpr int kMaxColors = 64;
+
+// 并行时每个任务至少处理的弹簧数，避免任务调度开销超过计算本身
+constexpr int kMinSpringsPerTask = 256;
+
+// 贪心图着色：共享任一 DOF 的两根弹簧不能同色，这样同色弹簧写入
+// qfrc_passive 的位置互不相交，可以无锁并行累加。
+// 返回每根弹簧的颜色，kMaxColors 表示无法着色（串行类）。
+std::vector<int> ColorSprings(const mjModel* m, const BodyChains& chains,
+                              const std::vector<std::pair<int, int>>& pairs) {
+  std::vector<std::uint64_t> used(m->nv, 0);  // 每个 DOF 已被哪些颜色占用
+  std::vector<int> color(pairs.size());
+  for (std::size_t i = 0; i < pairs.size(); ++i) {
+    const int bodies[2] = {pairs[i].first, pairs[i].second};
+    std::uint64_t taken = 0;
+    for (int body : bodies) {
+      const int* dof = chains.dofs(body);
+      for (int j = 0; j < chains.ndof(body); ++j) taken |= used[dof[j]];
+    }
+    int c = 0;
+    while (c < kMaxColors && (taken >> c) & 1) ++c;
+    color[i] = c;
+    if (c == kMaxColors) continue;
+    for (int body : bodies) {
+      const int* dof = chains.dofs(body);
+      for (int j = 0; j < chains.ndof(body); ++j) {
+        used[dof[j]] |= std::uint64_t{1} << c;
+      }
+    }
+  }
+  return color;
+}
+
 }  // namespace
 
 // --------------------------- SpringConfig -----------------------------------
@@ -75,44 +264,458 @@ std::optional<SpringConfig> SpringConfig::FromModel(const mjModel* m,
                                                    int instance) {
   SpringConfig config;
 
-  // 1) 读取数值参数
+  // 1) 读取数值参数（对本实例中所有弹簧生效）
   config.stiffness   = ReadOptionalDoubleAttr(m, instance, "stiffness").value_or(100.0);
   config.damping     = ReadOptionalDoubleAttr(m, instance, "damping").value_or(10.0);
   config.rest_length = ReadOptionalDoubleAttr(m, instance, "restlength").value_or(-1.0);
 
-  // 2) 读取两刚体名称
+  // 2) 单根弹簧：body1 / body2
   auto body1_name = ReadStringAttr(m, instance, "body1");
   auto body2_name = ReadStringAttr(m, instance, "body2");
-
-  if (!body1_name || !body2_name) {
-    mju_warning("Spring plugin requires 'body1' and 'body2' attributes.");
+  if (body1_name.has_value() != body2_name.has_value()) {
+    mju_warning("Spring plugin requires both 'body1' and 'body2' attributes.");
     return std::nullopt;
   }
+  if (body1_name) {
+    int id1 = FindBody(m, *body1_name);
+    int id2 = FindBody(m, *body2_name);
+    if (id1 < 0 || id2 < 0) {
+      return std::nullopt;
+    }
+    config.pairs.emplace_back(id1, id2);
+  }
 
-  // 3) 用名称查询刚体 ID
-  config.body1_id = mj_name2id(m, mjOBJ_BODY, body1_name->c_str());
-  config.body2_id = mj_name2id(m, mjOBJ_BODY, body2_name->c_str());
+  // 3) 批量声明：pairs 列表
+  if (auto pairs = ReadStringAttr(m, instance, "pairs")) {
+    std::istringstream stream(*pairs);
+    std::string token;
+    while (stream >> token) {
+      if (!ParsePairToken(m, token, &config.pairs)) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  // 4) 批量声明：chain 模式，匹配到的刚体按 ID 顺序首尾相连
+  if (auto chain = ReadStringAttr(m, instance, "chain")) {
+    int previous = -1;
+    for (int b = 0; b < m->nbody; ++b) {
+      const char* name = mj_id2name(m, mjOBJ_BODY, b);
+      if (!name || !GlobMatch(chain->c_str(), name)) continue;
+      if (previous >= 0) {
+        config.pairs.emplace_back(previous, b);
+      }
+      previous = b;
+    }
+  }
 
-  if (config.body1_id < 0 || config.body2_id < 0) {
-    mju_warning("Could not find bodies for spring plugin.");
+  if (config.pairs.empty()) {
+    mju_warning("Spring plugin requires 'body1'/'body2', 'pairs' or 'chain'.");
     return std::nullopt;
   }
 
+  // 5) 隐式模式
+  if (auto implicit = ReadStringAttr(m, instance, "implicit")) {
+    if (*implicit == "true") {
+      config.implicit = true;
+    } else if (*implicit == "false") {
+      config.implicit = false;
+    } else {
+      mju_warning("Spring plugin: 'implicit' must be 'true' or 'false'.");
+      return std::nullopt;
+    }
+  }
+
+  // 6) 力学模型
+  if (auto law = ReadStringAttr(m, instance, "law")) {
+    auto parsed = ParseSpringLaw(*law);
+    if (!parsed) {
+      mju_warning("Spring plugin: unknown law '%s'.", law->c_str());
+      return std::nullopt;
+    }
+    config.law = *parsed;
+  }
+  config.cubic = ReadOptionalDoubleAttr(m, instance, "cubic").value_or(0.0);
+  if (config.law == SpringLaw::kTableLinear) {
+    auto table = ReadStringAttr(m, instance, "table");
+    if (!table) {
+      mju_warning("Spring plugin: law 'table' requires the 'table' attribute.");
+      return std::nullopt;
+    }
+    std::istringstream stream(*table);
+    double value;
+    while (stream >> value) config.table.push_back(value);
+    if (!stream.eof() || config.table.size() < 4 || config.table.size() % 2) {
+      mju_warning("Spring plugin: 'table' must hold at least two "
+                  "'extension force' pairs.");
+      return std::nullopt;
+    }
+    for (std::size_t j = 2; j < config.table.size(); j += 2) {
+      if (!(config.table[j] > config.table[j - 2])) {
+        mju_warning("Spring plugin: 'table' extensions must be increasing.");
+        return std::nullopt;
+      }
+    }
+    config.table_size = static_cast<int>(
+        ReadOptionalDoubleAttr(m, instance, "tablesize").value_or(64));
+    if (config.table_size < 2) {
+      mju_warning("Spring plugin: 'tablesize' must be at least 2.");
+      return std::nullopt;
+    }
+    std::string interp = ReadStringAttr(m, instance, "interp").value_or("linear");
+    if (interp == "cubic") {
+      config.law = SpringLaw::kTableCubic;
+    } else if (interp != "linear") {
+      mju_warning("Spring plugin: 'interp' must be 'linear' or 'cubic'.");
+      return std::nullopt;
+    }
+    // 表给出的是力本身，stiffness 仅作缩放
+    config.stiffness = ReadOptionalDoubleAttr(m, instance, "stiffness").value_or(1.0);
+  }
+
+  // 7) 静止弹簧休眠
+  if (auto sleep = ReadStringAttr(m, instance, "sleep")) {
+    if (*sleep == "true") {
+      config.sleep = true;
+    } else if (*sleep != "false") {
+      mju_warning("Spring plugin: 'sleep' must be 'true' or 'false'.");
+      return std::nullopt;
+    }
+  }
+  config.sleep_velocity =
+      ReadOptionalDoubleAttr(m, instance, "sleepvel").value_or(config.sleep_velocity);
+  config.sleep_stretch =
+      ReadOptionalDoubleAttr(m, instance, "sleepstretch").value_or(config.sleep_stretch);
+  config.sleep_force =
+      ReadOptionalDoubleAttr(m, instance, "sleepforce").value_or(config.sleep_force);
+  config.sleep_interval = std::max(1, static_cast<int>(
+      ReadOptionalDoubleAttr(m, instance, "sleepinterval").value_or(8)));
+
+  // 8) 可视化
+  if (auto visualize = ReadStringAttr(m, instance, "visualize")) {
+    if (*visualize == "false") {
+      config.visualize = false;
+    } else if (*visualize != "true") {
+      mju_warning("Spring plugin: 'visualize' must be 'true' or 'false'.");
+      return std::nullopt;
+    }
+  }
+  config.vis_width =
+      ReadOptionalDoubleAttr(m, instance, "viswidth").value_or(config.vis_width);
+  config.vis_lod = static_cast<int>(
+      ReadOptionalDoubleAttr(m, instance, "vislod").value_or(config.vis_lod));
+  config.vis_max_geom = static_cast<int>(
+      ReadOptionalDoubleAttr(m, instance, "vismaxgeom").value_or(config.vis_max_geom));
+  config.vis_strain =
+      ReadOptionalDoubleAttr(m, instance, "visstrain").value_or(config.vis_strain);
+  if (!(config.vis_strain > 0)) config.vis_strain = 0.1;
+
+  // 9) 核函数指令集
+  config.simd = ReadStringAttr(m, instance, "simd").value_or("auto");
+  if (config.simd != "auto" && !ParseSpringIsa(config.simd)) {
+    mju_warning("Spring plugin: unknown simd '%s', using auto.",
+                config.simd.c_str());
+    config.simd = "auto";
+  }
+
   return config;
 }
 
 // ------------------------------ Spring --------------------------------------
 // 工厂：创建插件实例（返回 unique_ptr 由 MuJoCo 托管）
-std::unique_ptr<Spring> Spring::Create(const mjModel* m, int instance) {
+std::unique_ptr<Spring> Spring::Create(const mjModel* m, mjData* d,
+                                       int instance) {
   auto config = SpringConfig::FromModel(m, instance);
   if (!config) {
     return nullptr;  // 配置解析失败
   }
-  return std::unique_ptr<Spring>(new Spring(*config));
+  std::unique_ptr<Spring> spring(new Spring(m, d, instance, std::move(*config)));
+  // init 之前的 reset 回调拿不到实例，缺省参数在这里写入
+  spring->Reset(d->plugin_state + m->plugin_stateadr[instance]);
+  return spring;
+}
+
+// plugin_state 大小：每根弹簧 3 个参数。nstate 在编译期调用，只能从配置推算
+int Spring::StateSize(const mjModel* m, int instance) {
+  auto config = SpringConfig::FromModel(m, instance);
+  return config ? 3 * static_cast<int>(config->pairs.size()) : 0;
+}
+
+// 传感器维度：每根弹簧 3 个输出，开启休眠时末尾再加被跳过的弹簧数
+int Spring::SensorSize(const mjModel* m, int instance) {
+  auto config = SpringConfig::FromModel(m, instance);
+  if (!config) return 0;
+  return 3 * static_cast<int>(config->pairs.size()) + (config->sleep ? 1 : 0);
+}
+
+void Spring::Reset(mjtNum* plugin_state) {
+  std::copy(default_state_.begin(), default_state_.end(), plugin_state);
+  std::fill(asleep_.begin(), asleep_.end(), 0);
+  step_ = 0;
+  skipped_ = 0;
+}
+
+// 参数可能已被 mj_setState 等修改：逐字节比较，只有变化时才重算系数
+void Spring::SyncState(const mjModel* m, const mjData* d) {
+  const mjtNum* state = d->plugin_state + m->plugin_stateadr[instance_];
+  if (std::memcmp(state, applied_state_.data(),
+                  applied_state_.size() * sizeof(mjtNum)) != 0) {
+    ApplyState(m, state);
+  } else if (implicit_ && m->opt.timestep != coefficient_timestep_) {
+    // 步长可在运行时修改，隐式系数需随之更新
+    UpdateCoefficients(m->opt.timestep);
+  }
+}
+
+// 将 plugin_state（声明顺序）写入按颜色分组存放的 SoA 数组，并更新核函数系数
+void Spring::ApplyState(const mjModel* m, const mjtNum* state) {
+  const int n = size();
+  applied_state_.assign(state, state + 3 * n);
+  for (int i = 0; i < n; ++i) {
+    const int id = spring_id_[i];
+    stiffness_[i] = state[id];
+    damping_[i] = state[n + id];
+    rest_length_[i] = state[2 * n + id];
+  }
+  std::fill(asleep_.begin(), asleep_.end(), 0);  // 冻结的力已失效
+  UpdateCoefficients(m->opt.timestep);
+}
+
+// 构造函数 – 将配置展开为 SoA 数组，并预先确定每根弹簧的自然长度
+Spring::Spring(const mjModel* m, const mjData* d, int instance,
+               SpringConfig config)
+    : config_(std::move(config)), data_(d), instance_(instance) {
+  const int n = static_cast<int>(config_.pairs.size());
+
+  // 被引用的刚体：速度由同一 mjData 上的所有 passive 插件共享，每步只算一次
+  std::vector<int> bodies;
+  bodies.reserve(2 * n);
+  for (const auto& pair : config_.pairs) {
+    bodies.push_back(pair.first);
+    bodies.push_back(pair.second);
+  }
+  velocity_cache_ = BodyVelocityCache::Acquire(m, d, instance, bodies);
+  chains_ = BodyChains(m, bodies);
+
+  // 按冲突图着色并按颜色分组存放，同色弹簧可在线程池上并行计算
+  std::vector<int> color = ColorSprings(m, chains_, config_.pairs);
+  int ncolor = n ? *std::max_element(color.begin(), color.end()) + 1 : 0;
+  serial_tail_ = ncolor > kMaxColors;
+  color_adr_.assign(ncolor + 1, 0);
+  for (int c : color) ++color_adr_[c + 1];
+  for (int c = 0; c < ncolor; ++c) color_adr_[c + 1] += color_adr_[c];
+  spring_id_.resize(n);
+  std::vector<int> next(color_adr_.begin(), color_adr_.end() - 1);
+  for (int i = 0; i < n; ++i) {
+    spring_id_[next[color[i]]++] = i;  // 同色内保持声明顺序
+  }
+
+  body1_.resize(n);
+  body2_.resize(n);
+  stiffness_.assign(n, config_.stiffness);
+  damping_.assign(n, config_.damping);
+  rest_length_.resize(n);
+
+  for (int i = 0; i < n; ++i) {
+    body1_[i] = config_.pairs[spring_id_[i]].first;
+    body2_[i] = config_.pairs[spring_id_[i]].second;
+
+    // 若未显式设置 restlength，则将模型初始距离视为自然长度。
+    if (config_.rest_length < 0) {
+      mjtNum init_pos1[3], init_pos2[3];
+      BodyInitialPosition(m, body1_[i], init_pos1);
+      BodyInitialPosition(m, body2_[i], init_pos2);
+      rest_length_[i] = mju_dist3(init_pos1, init_pos2);
+    } else {
+      rest_length_[i] = config_.rest_length;
+    }
+  }
+
+  // 引用本实例的插件传感器（可选）
+  for (int i = 0; i < m->nsensor; ++i) {
+    if (m->sensor_type[i] == mjSENS_PLUGIN && m->sensor_plugin[i] == instance) {
+      sensor_adr_ = m->sensor_adr[i];
+      break;
+    }
+  }
+
+  // plugin_state 布局下的缺省参数：[刚度 | 阻尼 | 自然长度]，按声明顺序
+  default_state_.resize(3 * n);
+  for (int i = 0; i < n; ++i) {
+    const int id = spring_id_[i];
+    default_state_[id] = stiffness_[i];
+    default_state_[n + id] = damping_[i];
+    default_state_[2 * n + id] = rest_length_[i];
+  }
+  applied_state_ = default_state_;
+
+  // 核函数按 3*body 收集位置与速度
+  adr1_.resize(n);
+  adr2_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    adr1_[i] = 3 * body1_[i];
+    adr2_[i] = 3 * body2_[i];
+  }
+  dir_x_.resize(n);
+  dir_y_.resize(n);
+  dir_z_.resize(n);
+  length_.resize(n);
+  rate_.resize(n);
+  force_.resize(n);
+  if (config_.sleep) {
+    asleep_.assign(n, 0);
+    check_length_.assign(rest_length_.begin(), rest_length_.end());
+  }
+
+  // 隐式模式：两端刚体在 qpos0 处的平移逆质量之和，即弹簧方向上的
+  // J M^-1 J^T 投影（body_invweight0 的近似）
+  implicit_ = config_.implicit;
+  inv_weight_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    inv_weight_[i] = m->body_invweight0[2 * body1_[i]] +
+                     m->body_invweight0[2 * body2_[i]];
+  }
+  if (config_.law == SpringLaw::kTableLinear ||
+      config_.law == SpringLaw::kTableCubic) {
+    BuildTable();
+    args_.table = &table_;
+  }
+
+  // 选择核函数：auto 取 CPU 支持的最宽指令集，特化版本由系数决定
+  isa_ = DetectSpringIsa();
+  if (auto requested = ParseSpringIsa(config_.simd)) {
+    if (SpringIsaSupported(*requested)) {
+      isa_ = *requested;
+    } else {
+      mju_warning("Spring plugin: simd '%s' is not supported here, using '%s'.",
+                  config_.simd.c_str(), SpringIsaName(isa_));
+    }
+  }
+  alpha_.resize(n);
+  extra_damping_.resize(n);
+  kernel_stiffness_.resize(n);
+  kernel_damping_.resize(n);
+  kernel_cubic_.resize(n);
+  UpdateCoefficients(m->opt.timestep);
+
+  args_.body_vel = velocity_cache_->data();
+  args_.adr1 = adr1_.data();
+  args_.adr2 = adr2_.data();
+  args_.stiffness = kernel_stiffness_.data();
+  args_.damping = kernel_damping_.data();
+  args_.rest_length = rest_length_.data();
+  args_.cubic = kernel_cubic_.data();
+  args_.dir_x = dir_x_.data();
+  args_.dir_y = dir_y_.data();
+  args_.dir_z = dir_z_.data();
+  args_.length = length_.data();
+  args_.rate = rate_.data();
+  args_.force = force_.data();
+}
+
+Spring::~Spring() {
+  BodyVelocityCache::Release(data_, instance_);
+}
+
+// 隐式修正（近似）– MuJoCo 不允许插件向 qDeriv 写入导数（mjd_smooth_vel
+// 会在插件计算之后重建它），因此只在每根弹簧内部做一个线性化的近似：
+//   把弹簧看作沿自身方向的孤立一维系统 s'' = -W (k (s - L) + c s')，
+//   W 为两端逆质量之和，对其做后向欧拉并利用解析导数 ∂F/∂s = k、
+//   ∂F/∂s' = c 得到
+//   F = α (k (s - L) + (c + h k) s')，  α = 1 / (1 + h W (c + h k))
+// 这并不等价于隐式求解：真正的后向欧拉除以 (1 + h W (c + h k)) 的是沿
+// 弹簧方向的合力（含重力等外载），这里只缩放弹簧自身的力，弹性项也被
+// 乘以 α。因此静平衡随步长移动：承受外载 F 的弹簧停在 F / (α k) 而不是
+// F / k 处，即伸长为真实值的 1/α 倍（k=1e4、m=0.05、W=2/m、h=0.01 时
+// α≈0.024，约 40 倍）。稳定性主要来自这一软化，只适合不关心静态伸长的
+// 场景。
+// α 只依赖参数与步长，因此折算进核函数系数，核函数本身保持不变。
+// 非线性模型以 k 乘表的最大斜率作为切向刚度；cubic 只计入线性部分 k。
+void Spring::UpdateCoefficients(mjtNum h) {
+  const int n = size();
+  bool stiff = false, damp = false;
+  for (int i = 0; i < n; ++i) {
+    mjtNum alpha = 1;
+    mjtNum damping = damping_[i];
+    if (implicit_) {
+      damping += h * tangent_scale_ * stiffness_[i];
+      alpha = 1 / (1 + h * inv_weight_[i] * damping);
+    }
+    alpha_[i] = alpha;
+    extra_damping_[i] = damping - damping_[i];
+    kernel_stiffness_[i] = alpha * stiffness_[i];
+    kernel_damping_[i] = alpha * damping;
+    kernel_cubic_[i] = alpha * config_.cubic;
+    stiff |= kernel_stiffness_[i] != 0 ||
+             (config_.law == SpringLaw::kCubic && kernel_cubic_[i] != 0);
+    damp |= kernel_damping_[i] != 0;
+  }
+  coefficient_timestep_ = h;
+
+  // 全为零的刚度 / 阻尼项选用去掉该项的特化核函数
+  kernel_ = GetSpringKernel(isa_, config_.law, stiff, damp);
 }
 
-// 构造函数 – 仅保存配置
-Spring::Spring(SpringConfig config) : config_(std::move(config)) {}
+// 把测量曲线重采样到均匀网格，并为每个单元预先算好插值多项式系数，
+// 核函数只需一次截断取整即可定位单元，无需搜索
+void Spring::BuildTable() {
+  const bool cubic = config_.law == SpringLaw::kTableCubic;
+  const std::vector<double>& points = config_.table;
+  const int npoint = config_.table_size;
+  const int ncell = npoint - 1;
+
+  table_.lower = points.front();
+  table_.upper = points[points.size() - 2];
+  const mjtNum step = (table_.upper - table_.lower) / ncell;
+  table_.inv_step = 1 / step;
+  table_.last_cell = ncell - 1;
+
+  std::vector<mjtNum> f(npoint);
+  for (int j = 0; j < npoint; ++j) {
+    mjtNum x = j == ncell ? table_.upper : table_.lower + j * step;
+    f[j] = EvaluateMeasured(points, x, cubic);
+  }
+
+  // 网格点切线（以单元为单位）：内部取中心差分，两端取单侧差分
+  std::vector<mjtNum> tangent(npoint);
+  for (int j = 0; j < npoint; ++j) {
+    int lo = std::max(j - 1, 0), hi = std::min(j + 1, ncell);
+    tangent[j] = (f[hi] - f[lo]) / (hi - lo);
+  }
+
+  table_coef_.assign(4 * ncell, 0);
+  mjtNum* c0 = table_coef_.data();
+  mjtNum* c1 = c0 + ncell;
+  mjtNum* c2 = c1 + ncell;
+  mjtNum* c3 = c2 + ncell;
+  tangent_scale_ = 0;
+  for (int j = 0; j < ncell; ++j) {
+    mjtNum delta = f[j + 1] - f[j];
+    c0[j] = f[j];
+    if (cubic) {  // 三次 Hermite
+      c1[j] = tangent[j];
+      c2[j] = 3 * delta - 2 * tangent[j] - tangent[j + 1];
+      c3[j] = -2 * delta + tangent[j] + tangent[j + 1];
+      tangent_scale_ = std::max(tangent_scale_, std::abs(tangent[j]) * table_.inv_step);
+    } else {
+      c1[j] = delta;
+    }
+    tangent_scale_ = std::max(tangent_scale_, std::abs(delta) * table_.inv_step);
+  }
+  // 各网格点处的累积积分，供势能计算
+  table_integral_.assign(npoint, 0);
+  for (int j = 0; j < ncell; ++j) {
+    table_integral_[j + 1] = table_integral_[j] +
+        step * (c0[j] + c1[j] / 2 + c2[j] / 3 + c3[j] / 4);
+  }
+  table_.slope_lower = (cubic ? tangent[0] : f[1] - f[0]) * table_.inv_step;
+  table_.slope_upper =
+      (cubic ? tangent[ncell] : f[ncell] - f[ncell - 1]) * table_.inv_step;
+  table_.c0 = c0;
+  table_.c1 = c1;
+  table_.c2 = c2;
+  table_.c3 = c3;
+}
 
 // Compute 回调 – 在每个仿真子步调用 (mj_step 等函数内部)
 // 参数：
@@ -120,49 +723,285 @@ Spring::Spring(SpringConfig config) : config_(std::move(config)) {}
 //   d        – 时变数据，可写
 //   instance – 当前插件实例索引
 void Spring::Compute(const mjModel* m, mjData* d, int /*instance*/) {
-  // ---------- 1) 获取两刚体质心位置（世界坐标系） ----------
-  mjtNum* pos1 = d->xpos + 3 * config_.body1_id;  // x,y,z 地址
-  mjtNum* pos2 = d->xpos + 3 * config_.body2_id;
-
-  // ---------- 2) 计算两点之间的向量与距离 ----------
-  mjtNum vec[3];
-  mju_sub3(vec, pos2, pos1);           // vec = pos2 - pos1
-  mjtNum distance = mju_normalize3(vec);  // 单位化 vec，同时返回长度
-
-  // ---------- 3) 确定自然长度 ----------
-  double rest_length = config_.rest_length;
-  if (rest_length < 0) {
-    // 若未显式设置 restlength，则将模型初始距离视为自然长度。
-    const mjtNum* init_pos1 = m->body_pos + 3 * config_.body1_id;
-    const mjtNum* init_pos2 = m->body_pos + 3 * config_.body2_id;
-    mjtNum init_vec[3];
-    mju_sub3(init_vec, init_pos2, init_pos1);
-    rest_length = mju_norm3(init_vec);
+  // ---------- 0) 同步 plugin_state 中的参数 ----------
+  SyncState(m, d);
+
+  // ---------- 1) 被引用刚体的线速度（世界坐标系，共享缓存） ----------
+  args_.body_vel = velocity_cache_->Update(d, instance_);
+
+  // ---------- 2) 逐颜色类计算，同类内可并行 ----------
+  args_.xpos = d->xpos;
+  check_step_ = config_.sleep && step_++ % config_.sleep_interval == 0;
+  auto* pool = reinterpret_cast<mjThreadPool*>(d->threadpool);
+  const int ncolor = static_cast<int>(color_adr_.size()) - 1;
+  for (int c = 0; c < ncolor; ++c) {
+    const int begin = color_adr_[c];
+    const int end = color_adr_[c + 1];
+    const bool serial = !pool || (serial_tail_ && c == ncolor - 1) ||
+                        end - begin < 2 * kMinSpringsPerTask;
+    if (serial) {
+      Evaluate(m, d, begin, end);
+      continue;
+    }
+
+    // 均分给工作线程，当前线程处理最后一块后等待其余任务完成
+    const int nchunk =
+        std::min(pool->nworker + 1, (end - begin) / kMinSpringsPerTask);
+    if (static_cast<int>(tasks_.size()) < nchunk) {
+      tasks_.resize(nchunk);
+    }
+    for (int k = 0; k < nchunk; ++k) {
+      SpringTask& task = tasks_[k];
+      task.spring = this;
+      task.m = m;
+      task.d = d;
+      task.begin = begin + static_cast<int>(
+          static_cast<long long>(end - begin) * k / nchunk);
+      task.end = begin + static_cast<int>(
+          static_cast<long long>(end - begin) * (k + 1) / nchunk);
+      if (k + 1 < nchunk) {
+        mju_defaultTask(&task.task);
+        task.task.func = &Spring::RunTask;
+        task.task.args = &task;
+        mju_threadPoolEnqueue(pool, &task.task);
+      }
+    }
+    const SpringTask& last = tasks_[nchunk - 1];
+    Evaluate(m, d, last.begin, last.end);
+    for (int k = 0; k + 1 < nchunk; ++k) {
+      mju_taskJoin(&tasks_[k].task);
+    }
+  }
+  evaluated_ = true;
+  if (config_.sleep) {
+    skipped_ = static_cast<int>(std::count(asleep_.begin(), asleep_.end(), 1));
   }
 
-  // ---------- 4) 计算弹簧拉力 (Hooke) + 阻尼 ----------
-  // Hooke: F = k * (Δx)
-  mjtNum force_magnitude = config_.stiffness * (distance - rest_length);
+  // ---------- 3) 弹性势能（mj_energyPos 已在本步清零 energy[0]） ----------
+  if (m->opt.enableflags & mjENBL_ENERGY) {
+    d->energy[0] += PotentialEnergy();
+  }
+}
 
-  // 阻尼:  F_damp = d * (v_rel · dir)
-  mjtNum vel1[3], vel2[3];  // 两刚体质心线速度
-  mju_zero3(vel1);
-  mju_zero3(vel2);
-  mj_objectVelocity(m, d, mjOBJ_BODY, config_.body1_id, vel1, 0 /*local*/);
-  mj_objectVelocity(m, d, mjOBJ_BODY, config_.body2_id, vel2, 0);
+// 传感器回调（VEL 阶段）：passive 阶段已算过时直接复用核函数结果，
+// 否则（例如 passive 被禁用）只运行核函数，不累加力
+void Spring::Sense(const mjModel* m, mjData* d) {
+  if (sensor_adr_ < 0) return;
+  if (!evaluated_) {
+    SyncState(m, d);
+    args_.body_vel = velocity_cache_->Update(d, instance_);
+    args_.xpos = d->xpos;
+    kernel_(args_, 0, size());
+  }
+  evaluated_ = false;
 
-  mjtNum vel_rel[3];
-  mju_sub3(vel_rel, vel2, vel1);                // 相对速度
-  mjtNum vel_along_spring = mju_dot3(vel_rel, vec);  // 投影到弹簧方向
-  force_magnitude += config_.damping * vel_along_spring;
+  mjtNum* sensordata = d->sensordata + sensor_adr_;
+  const int n = size();
+  for (int i = 0; i < n; ++i) {
+    mjtNum* out = sensordata + 3 * spring_id_[i];
+    out[0] = length_[i] - rest_length_[i];  // 伸长量
+    out[1] = rate_[i];                      // 伸长率
+    out[2] = PhysicalForce(i);              // 物理拉力（不含隐式修正）
+  }
+  if (config_.sleep) {
+    sensordata[3 * n] = skipped_;
+  }
+}
+
+// 可视化回调：一次遍历输出所有（抽稀后的）弹簧，几何体只进入 mjvScene，
+// 不增加模型中的 geom，因此不参与碰撞检测
+void Spring::Visualize(const mjModel* /*m*/, mjData* d,
+                       const mjvOption* /*opt*/, mjvScene* scn) {
+  if (!config_.visualize) return;
+  const int n = size();
+  const int budget = std::min(config_.vis_max_geom, scn->maxgeom - scn->ngeom);
+  if (n == 0 || budget <= 0) return;
+
+  // 细节层次：弹簧多时改用细线；超出几何体上限时按固定步长抽稀
+  const bool lines = n > config_.vis_lod;
+  const int type = lines ? mjGEOM_LINE : mjGEOM_CAPSULE;
+  const mjtNum width = lines ? 1 : config_.vis_width;  // 线宽单位为像素
+  const int stride = (n + budget - 1) / budget;
 
-  // ---------- 5) 合成力向量并施加 ----------
-  mjtNum force_vec[3];
-  mju_scl3(force_vec, vec, force_magnitude);  // F = dir * |F|
+  for (int i = 0; i < n; i += stride) {
+    const mjtNum* from = d->xpos + adr1_[i];
+    const mjtNum* to = d->xpos + adr2_[i];
+    mjtNum length = mju_dist3(from, to);
+    if (length < mjMINVAL) continue;  // 两端重合，无法确定方向
 
-  // xfrc_applied: [fx fy fz  mx my mz] – 施加在刚体质心上的外力/外矩
-  mju_addTo(d->xfrc_applied + 6 * config_.body1_id, force_vec, 3);  // 加到 body1
-  mju_subFrom(d->xfrc_applied + 6 * config_.body2_id, force_vec, 3);  // 反向加到 body2
+    // 应变着色：压缩 -> 蓝，自然长度 -> 灰，拉伸 -> 红
+    mjtNum strain = rest_length_[i] > mjMINVAL
+        ? (length - rest_length_[i]) / rest_length_[i] : 0;
+    float t = static_cast<float>(
+        std::clamp(strain / config_.vis_strain, mjtNum(-1), mjtNum(1)));
+    float tension = t > 0 ? t : 0;
+    float compression = t < 0 ? -t : 0;
+
+    mjvGeom* geom = scn->geoms + scn->ngeom;
+    mjv_initGeom(geom, mjGEOM_NONE, nullptr, nullptr, nullptr, nullptr);
+    mjv_connector(geom, type, width, from, to);
+    geom->objtype = mjOBJ_UNKNOWN;
+    geom->objid = -1;
+    geom->category = mjCAT_DECOR;
+    geom->rgba[0] = 0.6f + 0.4f * tension - 0.5f * compression;
+    geom->rgba[1] = 0.6f - 0.5f * tension - 0.5f * compression;
+    geom->rgba[2] = 0.6f - 0.5f * tension + 0.4f * compression;
+    geom->rgba[3] = 1.0f;
+    ++scn->ngeom;
+  }
+}
+
+// 弹性势能，按未经隐式修正的原始参数计算
+// 核函数输出 force_ = α (k f(x) + k3 x^3 + (c + h k_t) v)，各项系数都乘了 α，
+// 除以 α 再减去隐式附加阻尼即得 k f(x) + k3 x^3 + c v。绳索的截断不可逆，
+// 直接按线性模型重算。
+mjtNum Spring::PhysicalForce(int i) const {
+  if (!implicit_) return force_[i];
+  if (config_.law == SpringLaw::kCable) {
+    mjtNum x = length_[i] - rest_length_[i];
+    if (x <= 0) return 0;
+    return std::max<mjtNum>(stiffness_[i] * x + damping_[i] * rate_[i], 0);
+  }
+  return force_[i] / alpha_[i] - extra_damping_[i] * rate_[i];
+}
+
+mjtNum Spring::PotentialEnergy() const {
+  const int n = size();
+  mjtNum energy = 0;
+  const bool table = config_.law == SpringLaw::kTableLinear ||
+                     config_.law == SpringLaw::kTableCubic;
+  const mjtNum table_zero = table ? TableIntegral(0) : 0;
+  for (int i = 0; i < n; ++i) {
+    const mjtNum x = length_[i] - rest_length_[i];
+    switch (config_.law) {
+      case SpringLaw::kCable:
+        if (x > 0) energy += 0.5 * stiffness_[i] * x * x;
+        break;
+      case SpringLaw::kCubic:
+        energy += 0.5 * stiffness_[i] * x * x + 0.25 * config_.cubic * x * x * x * x;
+        break;
+      case SpringLaw::kTableLinear:
+      case SpringLaw::kTableCubic:
+        energy += stiffness_[i] * (TableIntegral(x) - table_zero);
+        break;
+      default:
+        energy += 0.5 * stiffness_[i] * x * x;
+    }
+  }
+  return energy;
+}
+
+// 表函数的原函数：单元内对插值多项式积分，表外对线性外推积分
+mjtNum Spring::TableIntegral(mjtNum x) const {
+  const mjtNum step = 1 / table_.inv_step;
+  const int last = static_cast<int>(table_.last_cell);
+  if (x < table_.lower) {
+    mjtNum dx = x - table_.lower;
+    return table_.c0[0] * dx + 0.5 * table_.slope_lower * dx * dx;
+  }
+  if (x > table_.upper) {
+    mjtNum dx = x - table_.upper;
+    mjtNum f = table_.c0[last] + table_.c1[last] + table_.c2[last] + table_.c3[last];
+    return table_integral_[last + 1] + f * dx + 0.5 * table_.slope_upper * dx * dx;
+  }
+  mjtNum u = (x - table_.lower) * table_.inv_step;
+  int j = std::min(static_cast<int>(u), last);
+  mjtNum t = u - j;
+  return table_integral_[j] +
+         step * t * (table_.c0[j] + t * (table_.c1[j] / 2 +
+                     t * (table_.c2[j] / 3 + t * table_.c3[j] / 4)));
+}
+
+// 线程池任务入口
+void* Spring::RunTask(void* args) {
+  auto* task = static_cast<SpringTask*>(args);
+  task->spring->Evaluate(task->m, task->d, task->begin, task->end);
+  return nullptr;
+}
+
+// 计算存储位置 [begin, end) 的弹簧：向量化核函数 + 稀疏 J^T 累加
+void Spring::Evaluate(const mjModel* m, mjData* d, int begin, int end) {
+  if (config_.sleep) {
+    EvaluateCulled(m, d, begin, end);
+    return;
+  }
+
+  // 向量化核函数：方向、长度、伸长率与拉力
+  // 弹性项由 law 决定，阻尼: F_damp = d * (v_rel · dir)
+  kernel_(args_, begin, end);
+
+  // 合成力向量，经稀疏 J^T 累加到 qfrc_passive
+  for (int i = begin; i < end; ++i) {
+    Scatter(m, d, i);
+  }
+}
+
+// 带休眠的计算，状态按存储位置逐根更新，同色类拆分到多线程时互不干扰
+void Spring::EvaluateCulled(const mjModel* m, mjData* d, int begin, int end) {
+  // 1) 唤醒：任一端刚体速度超过阈值
+  for (int i = begin; i < end; ++i) {
+    if (asleep_[i] && (Moving(adr1_[i]) || Moving(adr2_[i]))) {
+      asleep_[i] = 0;
+    }
+  }
+
+  // 2) 检查步：休眠弹簧只算长度，长度变化超过阈值则唤醒
+  if (check_step_) {
+    for (int i = begin; i < end; ++i) {
+      if (!asleep_[i]) continue;
+      mjtNum length = mju_dist3(d->xpos + adr1_[i], d->xpos + adr2_[i]);
+      if (std::abs(length - check_length_[i]) > config_.sleep_stretch) {
+        asleep_[i] = 0;
+      }
+    }
+  }
+
+  // 3) 对连续的清醒弹簧段运行核函数，休眠弹簧保留上次的结果
+  for (int i = begin; i < end;) {
+    if (asleep_[i]) {
+      ++i;
+      continue;
+    }
+    int j = i + 1;
+    while (j < end && !asleep_[j]) ++j;
+    kernel_(args_, i, j);
+    i = j;
+  }
+
+  // 4) 检查步：两端静止且长度几乎不变的弹簧进入休眠，冻结当前的力
+  if (check_step_) {
+    for (int i = begin; i < end; ++i) {
+      if (asleep_[i]) continue;
+      if (!Moving(adr1_[i]) && !Moving(adr2_[i]) &&
+          std::abs(length_[i] - check_length_[i]) <= config_.sleep_stretch) {
+        asleep_[i] = 1;
+      }
+      check_length_[i] = length_[i];
+    }
+  }
+
+  // 5) 累加：休眠弹簧使用冻结的力，可忽略的直接丢弃
+  for (int i = begin; i < end; ++i) {
+    if (asleep_[i] && std::abs(force_[i]) < config_.sleep_force) continue;
+    Scatter(m, d, i);
+  }
+}
+
+bool Spring::Moving(int adr) const {
+  const mjtNum* v = args_.body_vel + adr;
+  return mju_dot3(v, v) > config_.sleep_velocity * config_.sleep_velocity;
+}
+
+void Spring::Scatter(const mjModel* m, mjData* d, int i) {
+  const int body1 = body1_[i];
+  const int body2 = body2_[i];
+  mjtNum force_vec[3] = {dir_x_[i] * force_[i], dir_y_[i] * force_[i],
+                         dir_z_[i] * force_[i]};  // F = dir * |F|
+  chains_.AddForce(m, d, body1, force_vec, d->xpos + 3 * body1,
+                   d->qfrc_passive);  // 加到 body1
+  mju_scl3(force_vec, force_vec, -1);
+  chains_.AddForce(m, d, body2, force_vec, d->xpos + 3 * body2,
+                   d->qfrc_passive);  // 反向加到 body2
 }
 
 // --------------------------- 插件注册 ---------------------------------------
@@ -173,20 +1012,29 @@ void Spring::RegisterPlugin() {
   // 基本信息
   plugin.name = "mujoco.passive.spring";  // 唯一标识
   plugin.capabilityflags |= mjPLUGIN_PASSIVE;  // 指示 compute 回调在仿真循环被调用
+  plugin.capabilityflags |= mjPLUGIN_SENSOR;   // 可作为传感器输出弹簧遥测
+  plugin.needstage = mjSTAGE_VEL;              // 伸长率依赖速度
 
   // 声明可在 XML 使用的属性列表
   static const char* attributes[] = {"stiffness", "damping", "restlength",
-                                     "body1", "body2"};
+                                     "body1", "body2", "pairs", "chain",
+                                     "simd", "implicit", "law", "cubic",
+                                     "table", "tablesize", "interp", "sleep",
+                                     "sleepvel", "sleepstretch", "sleepforce",
+                                     "sleepinterval", "visualize", "viswidth",
+                                     "vislod", "vismaxgeom", "visstrain"};
   plugin.nattribute = sizeof(attributes) / sizeof(attributes[0]);
   plugin.attributes = attributes;
 
   // --- 以下设置各回调 ---
-  // nstate：插件需要的内部状态大小（字节），此处用 lambda 返回 0
-  plugin.nstate = +[](const mjModel*, int) { return 0; };
+  // nstate：plugin_state 中的 mjtNum 个数，存放可在运行时修改的弹簧参数
+  plugin.nstate = +[](const mjModel* m, int instance) {
+    return Spring::StateSize(m, instance);
+  };
 
   // init：创建并保存插件实例
   plugin.init = +[](const mjModel* m, mjData* d, int instance) {
-    auto spring = Spring::Create(m, instance);
+    auto spring = Spring::Create(m, d, instance);
     if (!spring) return -1;  // 创建失败让 MuJoCo 停止加载本实例
     d->plugin_data[instance] = reinterpret_cast<uintptr_t>(spring.release());
     return 0;
@@ -198,9 +1046,34 @@ void Spring::RegisterPlugin() {
     d->plugin_data[instance] = 0;
   };
 
-  // compute：每步调用
-  plugin.compute = +[](const mjModel* m, mjData* d, int instance, int /*stage*/) {
-    reinterpret_cast<Spring*>(d->plugin_data[instance])->Compute(m, d, instance);
+  // nsensordata：每根弹簧 3 个输出
+  plugin.nsensordata = +[](const mjModel* m, int instance, int /*sensor_id*/) {
+    return Spring::SensorSize(m, instance);
+  };
+
+  // reset：mj_resetData 时恢复 XML 中配置的参数（init 之前 plugin_data 为空）
+  plugin.reset = +[](const mjModel*, mjtNum* plugin_state, void* plugin_data,
+                     int /*instance*/) {
+    if (plugin_data) {
+      static_cast<Spring*>(plugin_data)->Reset(plugin_state);
+    }
+  };
+
+  // compute：passive 阶段一次处理本实例的全部弹簧，sensor 阶段输出遥测
+  plugin.compute = +[](const mjModel* m, mjData* d, int instance,
+                       int capability_bit) {
+    auto* spring = reinterpret_cast<Spring*>(d->plugin_data[instance]);
+    if (capability_bit & mjPLUGIN_SENSOR) {
+      spring->Sense(m, d);
+    } else {
+      spring->Compute(m, d, instance);
+    }
+  };
+
+  // visualize：向 mjvScene 输出按应变着色的连接几何体
+  plugin.visualize = +[](const mjModel* m, mjData* d, const mjvOption* opt,
+                         mjvScene* scn, int instance) {
+    reinterpret_cast<Spring*>(d->plugin_data[instance])->Visualize(m, d, opt, scn);
   };
 
   // 最终注册
@@ -17,41 +17,249 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <mujoco/mujoco.h>
 
+#include "body_chain.h"
+#include "body_velocity_cache.h"
+#include "spring_kernel.h"
+
 namespace mujoco::plugin::passive {
 
 // Configuration for the spring plugin
 struct SpringConfig {
-  double stiffness = 100.0;     // Spring stiffness (k)
-  double damping = 10.0;        // Damping coefficient (d)
-  double rest_length = -1.0;    // Rest length of the spring. If negative, it's computed from initial positions.
-  int body1_id = -1;            // ID of the first body
-  int body2_id = -1;            // ID of the second body
+  double stiffness = 100.0;     // Spring stiffness (k), shared by all pairs
+  double damping = 10.0;        // Damping coefficient (d), shared by all pairs
+  double rest_length = -1.0;    // Rest length of the springs. If negative, it's computed from initial positions.
+
+  // Force law and its extra parameters
+  SpringLaw law = SpringLaw::kLinear;
+  double cubic = 0.0;           // k3 of the cubic law
+  std::vector<double> table;    // Tabulated law: extension/force pairs x0 f0 x1 f1 ...
+  int table_size = 64;          // Grid points of the resampled lookup table
+
+  // Body id pairs connected by a spring, resolved from body1/body2, pairs and chain
+  std::vector<std::pair<int, int>> pairs;
+
+  // Force kernel instruction set: "auto" picks the widest one the CPU supports
+  std::string simd = "auto";
+
+  // Per-spring implicit correction of the applied forces (opt-in). An
+  // approximation that shifts static equilibrium with the timestep, see
+  // Spring::implicit().
+  bool implicit = false;
+
+  // Activity culling: springs whose bodies stay slower than sleep_velocity and
+  // whose length changes less than sleep_stretch between checks (every
+  // sleep_interval steps) keep their last force until either body moves.
+  // Frozen forces below sleep_force are dropped.
+  bool sleep = false;
+  double sleep_velocity = 1e-3;
+  double sleep_stretch = 1e-4;
+  double sleep_force = 1e-6;
+  int sleep_interval = 8;
+
+  // Visualization: springs are drawn as capsules of radius vis_width, or as
+  // lines when there are more than vis_lod of them. At most vis_max_geom geoms
+  // are emitted; larger networks are decimated uniformly. Color saturates at
+  // a strain of +-vis_strain.
+  bool visualize = true;
+  double vis_width = 0.005;
+  int vis_lod = 2000;
+  int vis_max_geom = 5000;
+  double vis_strain = 0.1;
 
   // Factory function to create a SpringConfig from the MuJoCo model
   static std::optional<SpringConfig> FromModel(const mjModel* m, int instance);
 };
 
-// The Spring plugin class
+// The Spring plugin class. One instance owns any number of springs.
 class Spring {
  public:
-  // Creates an instance of the Spring plugin.
-  static std::unique_ptr<Spring> Create(const mjModel* m, int instance);
+  // Creates an instance of the Spring plugin bound to d.
+  static std::unique_ptr<Spring> Create(const mjModel* m, mjData* d,
+                                        int instance);
+  ~Spring();
+
+  // Number of plugin_state entries of an instance: stiffness, damping and
+  // rest length of every spring, each block in declared order.
+  static int StateSize(const mjModel* m, int instance);
+
+  // Number of sensordata entries of an instance: extension, extension rate
+  // and force of every spring, interleaved per spring in declared order,
+  // followed by the number of skipped springs when sleeping is enabled.
+  static int SensorSize(const mjModel* m, int instance);
 
-  // Computes the spring force and applies it to the bodies.
+  // Writes the configured parameters into plugin_state.
+  // Also wakes every spring.
+  void Reset(mjtNum* plugin_state);
+
+  // Computes the forces of all springs and adds them to d->qfrc_passive.
+  // Parameters are read from plugin_state, so they can be changed between
+  // steps with mj_setState or by writing d->plugin_state directly.
   void Compute(const mjModel* m, mjData* d, int instance);
 
+  // Writes the telemetry of the latest evaluation into the plugin sensor, if
+  // the model declares one for this instance.
+  void Sense(const mjModel* m, mjData* d);
+
+  // Adds one connector geom per drawn spring to scn, colored by strain.
+  void Visualize(const mjModel* m, mjData* d, const mjvOption* opt,
+                 mjvScene* scn);
+
+  // Potential energy stored in the springs at the latest evaluation.
+  mjtNum PotentialEnergy() const;
+
+  // Number of springs owned by this instance.
+  int size() const { return static_cast<int>(body1_.size()); }
+
+  // Instruction set selected for the force kernel.
+  SpringIsa isa() const { return isa_; }
+
+  // Number of springs skipped by activity culling in the latest step.
+  int skipped() const { return skipped_; }
+
+  // Whether the per-spring implicit correction is on. This is an
+  // approximation, not an implicit solve: MuJoCo does not let plugins add to
+  // qDeriv, so each spring is treated as an isolated 1-D system along its axis
+  // with inverse mass W = body_invweight0(body1) + body_invweight0(body2),
+  // evaluated at qpos0, and its own force (the elastic term included) is
+  // scaled by alpha = 1 / (1 + h W (c + h k)) with the extra damping h k added.
+  // Backward Euler would divide the total axial force, external loads
+  // included, by that factor; scaling only the spring force softens it to
+  // alpha k instead. Static equilibrium therefore depends on the timestep: a
+  // spring carrying a load F settles at an extension of F / (alpha k) rather
+  // than F / k, e.g. about 40x too far for k = 1e4, m = 0.05, W = 2/m at
+  // h = 0.01. Most of the added stability comes from this softening. Coupling
+  // between springs sharing a body and any configuration dependence of W are
+  // ignored as well. Sensor output and energy report the physical (unscaled)
+  // spring force and potential.
+  bool implicit() const { return implicit_; }
+
+  // Force law all springs of this instance follow.
+  SpringLaw law() const { return config_.law; }
+
   // Registers the plugin with MuJoCo.
   static void RegisterPlugin();
 
  private:
   // Constructor is private to enforce creation via the factory method.
-  Spring(SpringConfig config);
+  Spring(const mjModel* m, const mjData* d, int instance, SpringConfig config);
+
+  // Recomputes the kernel coefficients for timestep h (see spring_damper.cc)
+  // and picks the kernel specialization matching them.
+  void UpdateCoefficients(mjtNum h);
+
+  // Force of spring i without the implicit correction: k f(x) + k3 x^3 + c v.
+  mjtNum PhysicalForce(int i) const;
+
+  // Resamples config_.table onto the uniform grid read by the kernel.
+  void BuildTable();
+
+  // Applies plugin_state if it changed, or refreshes the implicit coefficients
+  // if the timestep changed.
+  void SyncState(const mjModel* m, const mjData* d);
+
+  // Copies parameters from plugin_state into the stored spring order.
+  void ApplyState(const mjModel* m, const mjtNum* state);
+
+  // Evaluates stored springs [begin, end) and adds their forces to qfrc_passive.
+  void Evaluate(const mjModel* m, mjData* d, int begin, int end);
+
+  // Evaluate with activity culling: wakes, evaluates awake runs, puts springs
+  // to sleep on check steps, and scatters frozen forces of sleeping springs.
+  void EvaluateCulled(const mjModel* m, mjData* d, int begin, int end);
+
+  // Whether the body at velocity address adr moves faster than sleep_velocity.
+  bool Moving(int adr) const;
+
+  // Adds the force of stored spring i to qfrc_passive.
+  void Scatter(const mjModel* m, mjData* d, int i);
+
+  // Antiderivative of the tabulated law, zero at table_.lower.
+  mjtNum TableIntegral(mjtNum x) const;
+
+  // Thread pool entry point; `args` is a SpringTask.
+  static void* RunTask(void* args);
 
   SpringConfig config_;
+  const mjData* data_;   // mjData this instance is bound to
+  int instance_;
+
+  // Springs are stored grouped by color class: springs of one class touch
+  // disjoint DOFs, so a class can add to qfrc_passive from several threads.
+  std::vector<int> spring_id_;         // declared index of each stored spring
+  std::vector<int> color_adr_;         // first stored spring of each class, plus end
+  bool serial_tail_ = false;           // last class has conflicts, run it serially
+
+  // Per-spring data in structure-of-arrays layout, indexed by stored spring.
+  std::vector<int> body1_;             // ID of the first body
+  std::vector<int> body2_;             // ID of the second body
+  std::vector<mjtNum> stiffness_;      // k
+  std::vector<mjtNum> damping_;        // d
+  std::vector<mjtNum> rest_length_;    // resolved rest length (never negative)
+  std::vector<int> adr1_;              // 3*body1, gather offsets for the kernel
+  std::vector<int> adr2_;              // 3*body2
+  std::vector<mjtNum> inv_weight_;     // translational inverse mass of the pair at qpos0
+
+  // Parameters as configured, and as last read from plugin_state; both in the
+  // plugin_state layout.
+  std::vector<mjtNum> default_state_;
+  std::vector<mjtNum> applied_state_;
+
+  // Coefficients seen by the kernel: equal to stiffness_/damping_ in explicit
+  // mode, scaled by the implicit correction otherwise.
+  std::vector<mjtNum> kernel_stiffness_;
+  std::vector<mjtNum> kernel_damping_;
+  std::vector<mjtNum> kernel_cubic_;
+  std::vector<mjtNum> alpha_;          // implicit scale of each spring, 1 in explicit mode
+  std::vector<mjtNum> extra_damping_;  // damping added by the implicit correction (h k_t)
+  bool implicit_ = false;
+  mjtNum coefficient_timestep_ = -1;   // timestep the coefficients were built for
+
+  // Lookup table of the tabulated laws; table_ points into table_coef_.
+  std::vector<mjtNum> table_coef_;
+  SpringTable table_;
+  std::vector<mjtNum> table_integral_;  // antiderivative at each grid point
+  mjtNum tangent_scale_ = 1;           // max |df/dx|, stiffness scale used by the implicit correction
+
+  // Kernel outputs, indexed by spring.
+  std::vector<mjtNum> dir_x_, dir_y_, dir_z_;
+  std::vector<mjtNum> length_, rate_, force_;
+
+  // Activity culling state, indexed by stored spring.
+  std::vector<unsigned char> asleep_;
+  std::vector<mjtNum> check_length_;   // length at the previous check
+  bool check_step_ = false;            // this step re-checks extensions
+  int step_ = 0;
+  int skipped_ = 0;
+
+  int sensor_adr_ = -1;                // sensordata address of the plugin sensor
+  bool evaluated_ = false;             // kernel outputs are newer than the last Sense
+
+  // Body velocities shared with the other passive plugins on data_.
+  BodyVelocityCache* velocity_cache_ = nullptr;
+
+  // Cached Jacobian sparsity of the referenced bodies.
+  BodyChains chains_;
+
+  // Thread pool tasks, reused across steps.
+  struct SpringTask {
+    mjTask task;
+    Spring* spring;
+    const mjModel* m;
+    mjData* d;
+    int begin;
+    int end;
+  };
+  std::vector<SpringTask> tasks_;
+
+  SpringIsa isa_ = SpringIsa::kScalar;
+  SpringKernelFn kernel_ = nullptr;
+  SpringKernelArgs args_;
 };
 
 }  // namespace mujoco::plugin::passive
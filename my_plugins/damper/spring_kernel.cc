@@ -0,0 +1,103 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+//
+//  文件：spring_kernel.cc
+//  说明：
+//    弹簧力核函数的标量实现（位级参考）以及运行时指令集 / 力学模型分派。
+//    SSE2 / AVX2 / AVX-512 版本分别位于 spring_kernel_<isa>.cc，
+//    以各自的编译选项构建，仅在 CPU 支持时才会被选中。
+//
+// -----------------------------------------------------------------------------
+
+#include "spring_kernel.h"
+
+#include <optional>
+#include <string>
+
+#include "spring_kernel_impl.h"
+
+namespace mujoco::plugin::passive {
+
+SpringKernelFn SelectSpringKernelScalar(SpringLaw law, bool stiffness, bool damping) {
+  return SelectSpringKernel<ScalarVec>(law, stiffness, damping);
+}
+
+bool SpringIsaSupported(SpringIsa isa) {
+  switch (isa) {
+    case SpringIsa::kScalar:
+      return true;
+#if defined(DAMPER_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    case SpringIsa::kSse2:
+      return __builtin_cpu_supports("sse2");
+    case SpringIsa::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case SpringIsa::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+SpringIsa DetectSpringIsa() {
+  for (SpringIsa isa : {SpringIsa::kAvx512, SpringIsa::kAvx2, SpringIsa::kSse2}) {
+    if (SpringIsaSupported(isa)) return isa;
+  }
+  return SpringIsa::kScalar;
+}
+
+SpringKernelFn GetSpringKernel(SpringIsa isa, SpringLaw law, bool stiffness,
+                               bool damping) {
+  switch (isa) {
+#ifdef DAMPER_X86_KERNELS
+    case SpringIsa::kSse2:
+      return SelectSpringKernelSse2(law, stiffness, damping);
+    case SpringIsa::kAvx2:
+      return SelectSpringKernelAvx2(law, stiffness, damping);
+    case SpringIsa::kAvx512:
+      return SelectSpringKernelAvx512(law, stiffness, damping);
+#endif
+    default:
+      return SelectSpringKernelScalar(law, stiffness, damping);
+  }
+}
+
+const char* SpringIsaName(SpringIsa isa) {
+  switch (isa) {
+    case SpringIsa::kSse2:   return "sse2";
+    case SpringIsa::kAvx2:   return "avx2";
+    case SpringIsa::kAvx512: return "avx512";
+    default:                 return "scalar";
+  }
+}
+
+std::optional<SpringIsa> ParseSpringIsa(const std::string& name) {
+  for (SpringIsa isa : {SpringIsa::kScalar, SpringIsa::kSse2,
+                        SpringIsa::kAvx2, SpringIsa::kAvx512}) {
+    if (name == SpringIsaName(isa)) return isa;
+  }
+  return std::nullopt;
+}
+
+std::optional<SpringLaw> ParseSpringLaw(const std::string& name) {
+  // 插值方式由 interp 属性决定，这里统一按线性插值返回
+  if (name == "linear") return SpringLaw::kLinear;
+  if (name == "cable")  return SpringLaw::kCable;
+  if (name == "cubic")  return SpringLaw::kCubic;
+  if (name == "table")  return SpringLaw::kTableLinear;
+  return std::nullopt;
+}
+
+}  // namespace mujoco::plugin::passive
@@ -0,0 +1,112 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_H_
+#define MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_H_
+
+#include <optional>
+#include <string>
+
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::passive {
+
+// Force laws. The law is fixed per plugin instance and selects a kernel
+// specialization, so the inner loop never branches on it.
+enum class SpringLaw {
+  kLinear,        // k*x + c*v
+  kCable,         // like kLinear, but never pushes: zero when slack or compressing
+  kCubic,         // k*x + k3*x^3 + c*v, e.g. a bump stop
+  kTableLinear,   // k*f(x) + c*v, f tabulated, linear interpolation
+  kTableCubic,    // k*f(x) + c*v, f tabulated, cubic Hermite interpolation
+};
+
+// Uniform-grid lookup table for the tabulated laws, f(x) with x the extension.
+// Cell j covers [lower + j*step, lower + (j+1)*step) and evaluates the
+// polynomial c0[j] + t*(c1[j] + t*(c2[j] + t*c3[j])) in t in [0, 1]; the
+// linear law only reads c0 and c1. Outside [lower, upper] f is extended
+// linearly with the end slopes.
+struct SpringTable {
+  mjtNum lower = 0;
+  mjtNum upper = 0;
+  mjtNum inv_step = 0;                  // 1/step
+  mjtNum last_cell = 0;                 // number of cells - 1
+  mjtNum slope_lower = 0;               // df/dx below lower
+  mjtNum slope_upper = 0;               // df/dx above upper
+  const mjtNum* c0 = nullptr;
+  const mjtNum* c1 = nullptr;
+  const mjtNum* c2 = nullptr;
+  const mjtNum* c3 = nullptr;
+};
+
+// Inputs and outputs of the batched spring force kernel. All per-spring
+// arrays are indexed by spring; body data arrays are indexed by 3*body.
+struct SpringKernelArgs {
+  // Inputs
+  const mjtNum* xpos = nullptr;         // Body positions (d->xpos)
+  const mjtNum* body_vel = nullptr;     // Body linear velocities, 3*nbody
+  const int* adr1 = nullptr;            // 3*body1 per spring
+  const int* adr2 = nullptr;            // 3*body2 per spring
+  const mjtNum* stiffness = nullptr;
+  const mjtNum* damping = nullptr;
+  const mjtNum* rest_length = nullptr;
+  const mjtNum* cubic = nullptr;        // k3 per spring, SpringLaw::kCubic only
+  const SpringTable* table = nullptr;   // SpringLaw::kTable* only
+
+  // Outputs
+  mjtNum* dir_x = nullptr;              // Unit direction from body1 to body2
+  mjtNum* dir_y = nullptr;
+  mjtNum* dir_z = nullptr;
+  mjtNum* length = nullptr;             // Current spring length
+  mjtNum* rate = nullptr;               // Extension rate (relative velocity along dir)
+  mjtNum* force = nullptr;              // Tension magnitude applied along dir
+};
+
+// Evaluates springs [begin, end).
+using SpringKernelFn = void (*)(const SpringKernelArgs& args, int begin, int end);
+
+// Instruction sets the kernel is compiled for, in increasing width.
+enum class SpringIsa { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Returns the widest instruction set supported by both the build and the CPU.
+SpringIsa DetectSpringIsa();
+
+// Returns true if `isa` can run on this build and CPU.
+bool SpringIsaSupported(SpringIsa isa);
+
+// Returns the kernel for `isa`, which must be supported, specialized for `law`.
+// Pass stiffness = false if every stiffness (and k3) is zero and damping =
+// false if every damping is zero to get a kernel that skips those terms.
+SpringKernelFn GetSpringKernel(SpringIsa isa, SpringLaw law, bool stiffness,
+                               bool damping);
+
+const char* SpringIsaName(SpringIsa isa);
+
+// Parses "scalar", "sse2", "avx2" or "avx512".
+std::optional<SpringIsa> ParseSpringIsa(const std::string& name);
+
+// Parses "linear", "cable", "cubic" or "table".
+std::optional<SpringLaw> ParseSpringLaw(const std::string& name);
+
+// Per-ISA kernel tables, defined in spring_kernel_<isa>.cc.
+SpringKernelFn SelectSpringKernelScalar(SpringLaw law, bool stiffness, bool damping);
+#ifdef DAMPER_X86_KERNELS
+SpringKernelFn SelectSpringKernelSse2(SpringLaw law, bool stiffness, bool damping);
+SpringKernelFn SelectSpringKernelAvx2(SpringLaw law, bool stiffness, bool damping);
+SpringKernelFn SelectSpringKernelAvx512(SpringLaw law, bool stiffness, bool damping);
+#endif
+
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_H_
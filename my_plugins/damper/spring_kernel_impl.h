@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_IMPL_H_
+#define MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_IMPL_H_
+
+// Kernel body shared by all spring_kernel_<isa>.cc translation units. Include
+// only from those files; each one instantiates it with its own lane wrapper.
+
+#include <mujoco/mujoco.h>
+
+#include "spring_kernel.h"
+#include "spring_simd.h"
+
+namespace mujoco::plugin::passive {
+namespace {  // NOLINT(build/namespaces): see spring_simd.h
+
+// Elastic part of the force law for extension x, before scaling by k.
+// Linear and cable return x itself; the caller multiplies by stiffness.
+template <class V, SpringLaw kLaw>
+inline V ElasticTerm(const SpringKernelArgs& a, V x) {
+  if constexpr (kLaw == SpringLaw::kTableLinear || kLaw == SpringLaw::kTableCubic) {
+    // 均匀网格查表：先夹到表内求单元和局部坐标，表外按端点斜率线性外推
+    const SpringTable& t = *a.table;
+    V lower = V::Broadcast(t.lower);
+    V xc = Min(Max(x, lower), V::Broadcast(t.upper));
+    V u = (xc - lower) * V::Broadcast(t.inv_step);
+    V cell = Min(Trunc(u), V::Broadcast(t.last_cell));
+    V s = u - cell;
+    V f;
+    if constexpr (kLaw == SpringLaw::kTableCubic) {
+      f = V::GatherIndex(t.c0, cell) +
+          s*(V::GatherIndex(t.c1, cell) +
+             s*(V::GatherIndex(t.c2, cell) + s*V::GatherIndex(t.c3, cell)));
+    } else {
+      f = V::GatherIndex(t.c0, cell) + s*V::GatherIndex(t.c1, cell);
+    }
+    V slope = Select(Less(x, lower), V::Broadcast(t.slope_lower),
+                     V::Broadcast(t.slope_upper));
+    return f + slope*(x - xc);
+  } else {
+    return x;
+  }
+}
+
+// Evaluates V::kWidth springs starting at i. The order of every floating
+// point operation is fixed so all lane widths give bitwise identical results.
+// kStiff/kDamp drop the stiffness/damping terms when they are zero everywhere.
+template <class V, SpringLaw kLaw, bool kStiff, bool kDamp>
+inline void SpringLanes(const SpringKernelArgs& a, int i) {
+  const int* adr1 = a.adr1 + i;
+  const int* adr2 = a.adr2 + i;
+
+  // 1) 收集两端位置，计算方向与长度
+  V dx = V::Gather(a.xpos + 0, adr2) - V::Gather(a.xpos + 0, adr1);
+  V dy = V::Gather(a.xpos + 1, adr2) - V::Gather(a.xpos + 1, adr1);
+  V dz = V::Gather(a.xpos + 2, adr2) - V::Gather(a.xpos + 2, adr1);
+  V length = Sqrt(dx*dx + dy*dy + dz*dz);
+
+  // 与 mju_normalize3 一致：长度过小时方向取 (1, 0, 0)
+  auto degenerate = Less(length, V::Broadcast(mjMINVAL));
+  V inv = V::Broadcast(1.0) / length;
+  V ux = Select(degenerate, V::Broadcast(1.0), dx*inv);
+  V uy = Select(degenerate, V::Broadcast(0.0), dy*inv);
+  V uz = Select(degenerate, V::Broadcast(0.0), dz*inv);
+
+  // 2) 相对速度投影到弹簧方向
+  V rate = (V::Gather(a.body_vel + 0, adr2) - V::Gather(a.body_vel + 0, adr1))*ux +
+           (V::Gather(a.body_vel + 1, adr2) - V::Gather(a.body_vel + 1, adr1))*uy +
+           (V::Gather(a.body_vel + 2, adr2) - V::Gather(a.body_vel + 2, adr1))*uz;
+
+  // 3) 力学模型：弹性项 + 线性阻尼，为零的项在编译期去掉
+  V x = length - V::Load(a.rest_length + i);
+  V force = V::Broadcast(0.0);
+  if constexpr (kStiff) {
+    force = V::Load(a.stiffness + i) * ElasticTerm<V, kLaw>(a, x);
+    if constexpr (kLaw == SpringLaw::kCubic) {
+      force = force + ((V::Load(a.cubic + i) * x) * x) * x;
+    }
+  }
+  if constexpr (kDamp) {
+    if constexpr (kStiff) {
+      force = force + V::Load(a.damping + i) * rate;
+    } else {
+      force = V::Load(a.damping + i) * rate;
+    }
+  }
+
+  // 绳索只受拉：松弛时无力，张紧时阻尼也不能把合力变成推力
+  if constexpr (kLaw == SpringLaw::kCable) {
+    V zero = V::Broadcast(0.0);
+    force = Select(Less(zero, x), Max(force, zero), zero);
+  }
+
+  ux.Store(a.dir_x + i);
+  uy.Store(a.dir_y + i);
+  uz.Store(a.dir_z + i);
+  length.Store(a.length + i);
+  rate.Store(a.rate + i);
+  force.Store(a.force + i);
+}
+
+// Full vectors with V, remainder with the scalar reference.
+template <class V, SpringLaw kLaw, bool kStiff, bool kDamp>
+void SpringKernel(const SpringKernelArgs& a, int begin, int end) {
+  int i = begin;
+  for (; i + V::kWidth <= end; i += V::kWidth) {
+    SpringLanes<V, kLaw, kStiff, kDamp>(a, i);
+  }
+  for (; i < end; ++i) {
+    SpringLanes<ScalarVec, kLaw, kStiff, kDamp>(a, i);
+  }
+}
+
+template <class V, SpringLaw kLaw>
+SpringKernelFn SelectSpringTerms(bool stiffness, bool damping) {
+  if (stiffness && damping) return &SpringKernel<V, kLaw, true, true>;
+  if (stiffness) return &SpringKernel<V, kLaw, true, false>;
+  if (damping) return &SpringKernel<V, kLaw, false, true>;
+  return &SpringKernel<V, kLaw, false, false>;
+}
+
+// Instantiates every law x term combination for V and returns the requested one.
+template <class V>
+SpringKernelFn SelectSpringKernel(SpringLaw law, bool stiffness, bool damping) {
+  switch (law) {
+    case SpringLaw::kCable:
+      return SelectSpringTerms<V, SpringLaw::kCable>(stiffness, damping);
+    case SpringLaw::kCubic:
+      return SelectSpringTerms<V, SpringLaw::kCubic>(stiffness, damping);
+    case SpringLaw::kTableLinear:
+      return SelectSpringTerms<V, SpringLaw::kTableLinear>(stiffness, damping);
+    case SpringLaw::kTableCubic:
+      return SelectSpringTerms<V, SpringLaw::kTableCubic>(stiffness, damping);
+    default:
+      return SelectSpringTerms<V, SpringLaw::kLinear>(stiffness, damping);
+  }
+}
+
+}  // namespace
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_SPRING_KERNEL_IMPL_H_
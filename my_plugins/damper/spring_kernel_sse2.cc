@@ -0,0 +1,26 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// 弹簧力核函数的 SSE2 版本，编译选项：无需额外选项（x86-64 基线）。
+// 仅在 DetectSpringIsa() 确认 CPU 支持后才会被调用。
+
+#include "spring_kernel_impl.h"
+
+namespace mujoco::plugin::passive {
+
+SpringKernelFn SelectSpringKernelSse2(SpringLaw law, bool stiffness, bool damping) {
+  return SelectSpringKernel<Sse2Vec>(law, stiffness, damping);
+}
+
+}  // namespace mujoco::plugin::passive
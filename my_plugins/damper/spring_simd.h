@@ -0,0 +1,183 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MUJOCO_PLUGIN_PASSIVE_SPRING_SIMD_H_
+#define MUJOCO_PLUGIN_PASSIVE_SPRING_SIMD_H_
+
+// Thin lane wrappers used by the spring kernels. Every wrapper exposes the
+// same operations, so a kernel written once against them produces the same
+// IEEE results on every ISA (no FMA, correctly rounded sqrt and division).
+//
+// Only the wrappers supported by the compiler flags of the including
+// translation unit are defined. Everything lives in an anonymous namespace so
+// code compiled with different -m flags is never merged across translation
+// units by the linker.
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace mujoco::plugin::passive {
+namespace {  // NOLINT(build/namespaces): see comment above
+
+// One double per lane; the bitwise reference for all other wrappers.
+struct ScalarVec {
+  static constexpr int kWidth = 1;
+  using Mask = bool;
+  double v;
+
+  static ScalarVec Load(const double* p) { return {*p}; }
+  static ScalarVec Broadcast(double x) { return {x}; }
+  static ScalarVec Gather(const double* base, const int* idx) {
+    return {base[idx[0]]};
+  }
+  void Store(double* p) const { *p = v; }
+
+  friend ScalarVec operator+(ScalarVec a, ScalarVec b) { return {a.v + b.v}; }
+  friend ScalarVec operator-(ScalarVec a, ScalarVec b) { return {a.v - b.v}; }
+  friend ScalarVec operator*(ScalarVec a, ScalarVec b) { return {a.v * b.v}; }
+  friend ScalarVec operator/(ScalarVec a, ScalarVec b) { return {a.v / b.v}; }
+  friend ScalarVec Sqrt(ScalarVec a) { return {std::sqrt(a.v)}; }
+  // Same NaN semantics as maxpd/minpd: the second operand wins if unordered.
+  friend ScalarVec Max(ScalarVec a, ScalarVec b) { return {a.v > b.v ? a.v : b.v}; }
+  friend ScalarVec Min(ScalarVec a, ScalarVec b) { return {a.v < b.v ? a.v : b.v}; }
+  friend ScalarVec Trunc(ScalarVec a) { return {std::trunc(a.v)}; }
+  friend Mask Less(ScalarVec a, ScalarVec b) { return a.v < b.v; }
+  friend ScalarVec Select(Mask m, ScalarVec t, ScalarVec f) {
+    return m ? t : f;
+  }
+
+  // base[index] for a non-negative integral index held as a double.
+  static ScalarVec GatherIndex(const double* base, ScalarVec index) {
+    return {base[static_cast<int>(index.v)]};
+  }
+};
+
+#if defined(__SSE2__)
+struct Sse2Vec {
+  static constexpr int kWidth = 2;
+  using Mask = __m128d;
+  __m128d v;
+
+  static Sse2Vec Load(const double* p) { return {_mm_loadu_pd(p)}; }
+  static Sse2Vec Broadcast(double x) { return {_mm_set1_pd(x)}; }
+  static Sse2Vec Gather(const double* base, const int* idx) {
+    return {_mm_set_pd(base[idx[1]], base[idx[0]])};
+  }
+  void Store(double* p) const { _mm_storeu_pd(p, v); }
+
+  friend Sse2Vec operator+(Sse2Vec a, Sse2Vec b) { return {_mm_add_pd(a.v, b.v)}; }
+  friend Sse2Vec operator-(Sse2Vec a, Sse2Vec b) { return {_mm_sub_pd(a.v, b.v)}; }
+  friend Sse2Vec operator*(Sse2Vec a, Sse2Vec b) { return {_mm_mul_pd(a.v, b.v)}; }
+  friend Sse2Vec operator/(Sse2Vec a, Sse2Vec b) { return {_mm_div_pd(a.v, b.v)}; }
+  friend Sse2Vec Sqrt(Sse2Vec a) { return {_mm_sqrt_pd(a.v)}; }
+  friend Sse2Vec Max(Sse2Vec a, Sse2Vec b) { return {_mm_max_pd(a.v, b.v)}; }
+  friend Sse2Vec Min(Sse2Vec a, Sse2Vec b) { return {_mm_min_pd(a.v, b.v)}; }
+  // SSE2 has no roundpd; only used on table indices, which fit in int32.
+  friend Sse2Vec Trunc(Sse2Vec a) {
+    return {_mm_cvtepi32_pd(_mm_cvttpd_epi32(a.v))};
+  }
+  friend Mask Less(Sse2Vec a, Sse2Vec b) { return _mm_cmplt_pd(a.v, b.v); }
+  friend Sse2Vec Select(Mask m, Sse2Vec t, Sse2Vec f) {
+    return {_mm_or_pd(_mm_and_pd(m, t.v), _mm_andnot_pd(m, f.v))};
+  }
+
+  static Sse2Vec GatherIndex(const double* base, Sse2Vec index) {
+    alignas(16) int idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(idx), _mm_cvttpd_epi32(index.v));
+    return Gather(base, idx);
+  }
+};
+#endif  // __SSE2__
+
+#if defined(__AVX2__)
+struct Avx2Vec {
+  static constexpr int kWidth = 4;
+  using Mask = __m256d;
+  __m256d v;
+
+  static Avx2Vec Load(const double* p) { return {_mm256_loadu_pd(p)}; }
+  static Avx2Vec Broadcast(double x) { return {_mm256_set1_pd(x)}; }
+  static Avx2Vec Gather(const double* base, const int* idx) {
+    __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx));
+    return {_mm256_i32gather_pd(base, i, 8)};
+  }
+  void Store(double* p) const { _mm256_storeu_pd(p, v); }
+
+  friend Avx2Vec operator+(Avx2Vec a, Avx2Vec b) { return {_mm256_add_pd(a.v, b.v)}; }
+  friend Avx2Vec operator-(Avx2Vec a, Avx2Vec b) { return {_mm256_sub_pd(a.v, b.v)}; }
+  friend Avx2Vec operator*(Avx2Vec a, Avx2Vec b) { return {_mm256_mul_pd(a.v, b.v)}; }
+  friend Avx2Vec operator/(Avx2Vec a, Avx2Vec b) { return {_mm256_div_pd(a.v, b.v)}; }
+  friend Avx2Vec Sqrt(Avx2Vec a) { return {_mm256_sqrt_pd(a.v)}; }
+  friend Avx2Vec Max(Avx2Vec a, Avx2Vec b) { return {_mm256_max_pd(a.v, b.v)}; }
+  friend Avx2Vec Min(Avx2Vec a, Avx2Vec b) { return {_mm256_min_pd(a.v, b.v)}; }
+  friend Avx2Vec Trunc(Avx2Vec a) {
+    return {_mm256_round_pd(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)};
+  }
+  friend Mask Less(Avx2Vec a, Avx2Vec b) {
+    return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ);
+  }
+  friend Avx2Vec Select(Mask m, Avx2Vec t, Avx2Vec f) {
+    return {_mm256_blendv_pd(f.v, t.v, m)};
+  }
+
+  static Avx2Vec GatherIndex(const double* base, Avx2Vec index) {
+    return {_mm256_i32gather_pd(base, _mm256_cvttpd_epi32(index.v), 8)};
+  }
+};
+#endif  // __AVX2__
+
+#if defined(__AVX512F__)
+struct Avx512Vec {
+  static constexpr int kWidth = 8;
+  using Mask = __mmask8;
+  __m512d v;
+
+  static Avx512Vec Load(const double* p) { return {_mm512_loadu_pd(p)}; }
+  static Avx512Vec Broadcast(double x) { return {_mm512_set1_pd(x)}; }
+  static Avx512Vec Gather(const double* base, const int* idx) {
+    __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx));
+    return {_mm512_i32gather_pd(i, base, 8)};
+  }
+  void Store(double* p) const { _mm512_storeu_pd(p, v); }
+
+  friend Avx512Vec operator+(Avx512Vec a, Avx512Vec b) { return {_mm512_add_pd(a.v, b.v)}; }
+  friend Avx512Vec operator-(Avx512Vec a, Avx512Vec b) { return {_mm512_sub_pd(a.v, b.v)}; }
+  friend Avx512Vec operator*(Avx512Vec a, Avx512Vec b) { return {_mm512_mul_pd(a.v, b.v)}; }
+  friend Avx512Vec operator/(Avx512Vec a, Avx512Vec b) { return {_mm512_div_pd(a.v, b.v)}; }
+  friend Avx512Vec Sqrt(Avx512Vec a) { return {_mm512_sqrt_pd(a.v)}; }
+  friend Avx512Vec Max(Avx512Vec a, Avx512Vec b) { return {_mm512_max_pd(a.v, b.v)}; }
+  friend Avx512Vec Min(Avx512Vec a, Avx512Vec b) { return {_mm512_min_pd(a.v, b.v)}; }
+  friend Avx512Vec Trunc(Avx512Vec a) {
+    return {_mm512_roundscale_pd(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)};
+  }
+  friend Mask Less(Avx512Vec a, Avx512Vec b) {
+    return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ);
+  }
+  friend Avx512Vec Select(Mask m, Avx512Vec t, Avx512Vec f) {
+    return {_mm512_mask_blend_pd(m, f.v, t.v)};
+  }
+
+  static Avx512Vec GatherIndex(const double* base, Avx512Vec index) {
+    return {_mm512_i32gather_pd(_mm512_cvttpd_epi32(index.v), base, 8)};
+  }
+};
+#endif  // __AVX512F__
+
+}  // namespace
+}  // namespace mujoco::plugin::passive
+
+#endif  // MUJOCO_PLUGIN_PASSIVE_SPRING_SIMD_H_
@@ -0,0 +1,159 @@
+// -----------------------------------------------------------------------------
+//
+//  文件：bench/shm_latency.cc
+//  说明：
+//    共享内存快照（shm="<name>"）的延迟与开销测试，不依赖 mujoco。
+//    发布者线程以固定频率写帧，帧内所有分量都写入帧号，frame[0] 写入发布
+//    时刻；若干读者线程各自经 ShmReader 映射同一段并轮询序号，统计：
+//      • 发布开销 : BeginWrite 到 EndWrite 的耗时（含填帧）
+//      • 端到端延迟 : 发布时刻到读者拿到一致快照的时刻
+//      • 丢帧 : 读者两次快照间跳过的帧数（读者只关心最新帧，丢帧属正常）
+//      • 撕裂 : 快照内帧号不一致的次数，应恒为 0
+//
+//    读者忙等轮询，核数少于 nreader+1 时延迟主要反映调度而非共享内存本身。
+//
+//    用法：inspector_shm_latency [nreader] [nframe] [ndof] [rate_hz]
+//
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "frame_schema.h"
+#include "shm_publisher.h"
+#include "shm_reader.h"
+
+using mujoco::plugin::inspector::ChannelKind;
+using mujoco::plugin::inspector::FrameSchema;
+using mujoco::plugin::inspector::ShmPublisher;
+using mujoco::plugin::inspector::ShmReader;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double NowNs(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+struct ReaderStats {
+  std::vector<double> latency_ns;
+  uint64_t skipped = 0;
+  uint64_t torn = 0;
+};
+
+double Percentile(std::vector<double>* v, double p) {
+  if (v->empty()) return 0.0;
+  size_t k = static_cast<size_t>(p * (v->size() - 1));
+  std::nth_element(v->begin(), v->begin() + k, v->end());
+  return (*v)[k];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int nreader = argc > 1 ? std::atoi(argv[1]) : 2;
+  int nframe = argc > 2 ? std::atoi(argv[2]) : 20000;
+  int ndof = argc > 3 ? std::atoi(argv[3]) : 64;
+  double rate_hz = argc > 4 ? std::atof(argv[4]) : 1000.0;
+  if (nreader < 0 || nframe <= 0 || ndof <= 0 || rate_hz <= 0) {
+    std::fprintf(stderr,
+                 "usage: %s [nreader] [nframe] [ndof] [rate_hz]\n", argv[0]);
+    return 2;
+  }
+
+  FrameSchema schema;
+  schema.Append("bench", ChannelKind::kQpos, 0, ndof);
+  schema.Append("bench", ChannelKind::kQvel, 0, ndof);
+
+  std::string name = "/mj_inspector_bench_" + std::to_string(getpid());
+  std::string error;
+  auto publisher = ShmPublisher::Create(name, schema, &error);
+  if (!publisher) {
+    std::fprintf(stderr, "inspector_shm_latency: %s\n", error.c_str());
+    return 1;
+  }
+
+  Clock::time_point start = Clock::now();
+  std::atomic<bool> done{false};
+  std::atomic<int> ready{0};
+  std::vector<ReaderStats> stats(nreader);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < nreader; ++r) {
+    readers.emplace_back([&, r] {
+      ReaderStats& s = stats[r];
+      auto reader = ShmReader::Open(name);
+      ready.fetch_add(1);
+      if (!reader) return;
+      std::vector<double> frame(reader->schema().frame_size);
+      s.latency_ns.reserve(nframe);
+      uint64_t last = reader->sequence();
+      while (!done.load(std::memory_order_relaxed)) {
+        if (reader->sequence() == last) {
+          std::this_thread::yield();
+          continue;
+        }
+        std::optional<uint64_t> snapshot = reader->Snapshot(frame.data());
+        double now = NowNs(start);
+        if (!snapshot || *snapshot == last) continue;
+        uint64_t seq = *snapshot;
+        s.latency_ns.push_back(now - frame[0]);
+        if (last != 0) s.skipped += (seq - last) / 2 - 1;
+        for (size_t i = 2; i < frame.size(); ++i) {
+          if (frame[i] != frame[1]) { ++s.torn; break; }
+        }
+        last = seq;
+      }
+    });
+  }
+  while (ready.load() < nreader) std::this_thread::yield();
+
+  std::vector<double> publish_ns;
+  publish_ns.reserve(nframe);
+  auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / rate_hz));
+  Clock::time_point next = Clock::now();
+  for (int i = 0; i < nframe; ++i) {
+    next += period;
+    while (Clock::now() < next) {}
+
+    double t0 = NowNs(start);
+    double* frame = publisher->BeginWrite();
+    for (int k = 1; k < schema.frame_size; ++k) frame[k] = i;
+    frame[0] = NowNs(start);
+    publisher->EndWrite();
+    publish_ns.push_back(NowNs(start) - t0);
+  }
+  done.store(true);
+  for (std::thread& t : readers) t.join();
+
+  double mean = 0;
+  for (double v : publish_ns) mean += v;
+  mean /= publish_ns.size();
+  std::printf("frame %d doubles, %d frames at %.0f Hz\n",
+              schema.frame_size, nframe, rate_hz);
+  std::printf("publish   mean %8.0f ns   p99 %8.0f ns   max %8.0f ns\n",
+              mean, Percentile(&publish_ns, 0.99),
+              Percentile(&publish_ns, 1.0));
+  for (int r = 0; r < nreader; ++r) {
+    ReaderStats& s = stats[r];
+    std::printf("reader %d  p50 %8.0f ns   p99 %8.0f ns   max %8.0f ns"
+                "   frames %zu   skipped %llu   torn %llu\n",
+                r, Percentile(&s.latency_ns, 0.5),
+                Percentile(&s.latency_ns, 0.99),
+                Percentile(&s.latency_ns, 1.0), s.latency_ns.size(),
+                static_cast<unsigned long long>(s.skipped),
+                static_cast<unsigned long long>(s.torn));
+  }
+  bool ok = true;
+  for (const ReaderStats& s : stats) ok = ok && s.torn == 0;
+  return ok ? 0 : 1;
+}
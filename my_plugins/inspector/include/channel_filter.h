@@ -0,0 +1,53 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_CHANNEL_FILTER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_CHANNEL_FILTER_H_
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace mujoco::plugin::inspector {
+
+// 通道选择：include / exclude 各为空白分隔的模式列表。
+//
+//   模式    [对象:]表达式
+//   对象    joint / sensor / body；省略时对三者都生效。
+//           body 模式选中（或排除）该 body 上的全部关节。
+//   表达式  默认为通配符（* 任意串，? 任意单字符）；
+//           以 "re:" 开头时为 ECMAScript 正则，须整串匹配。
+//
+// 例：include="joint:arm_* sensor:re:imu_[0-9]+"  exclude="body:gripper"
+// include 为空时选中全部；exclude 优先于 include。
+class ChannelFilter {
+ public:
+  enum Object { kJoint = 0, kSensor, kBody, kNumObjects };
+
+  // 解析失败（非法正则）时返回 nullopt，并写入 error。
+  static std::optional<ChannelFilter> Parse(const std::string& include,
+                                            const std::string& exclude,
+                                            std::string* error);
+
+  // name 为 nullptr 时按空串匹配。
+  bool Included(Object object, const char* name) const;
+  bool Excluded(Object object, const char* name) const;
+
+ private:
+  struct Pattern {
+    int object = -1;     // -1 表示对所有对象生效
+    bool regex = false;
+    std::string glob;
+    std::regex re;
+  };
+
+  static bool Compile(const std::string& list, std::vector<Pattern>* out,
+                      std::string* error);
+  static bool Matches(const std::vector<Pattern>& patterns, Object object,
+                      const char* name);
+
+  std::vector<Pattern> include_;
+  std::vector<Pattern> exclude_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_CHANNEL_FILTER_H_
@@ -0,0 +1,82 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_FRAME_RING_H_
+#define MUJOCO_PLUGIN_INSPECTOR_FRAME_RING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace mujoco::plugin::inspector {
+
+// 单生产者/单消费者（SPSC）定长帧环形缓冲区。
+// 生产者（物理线程）只写 head_，消费者（写线程）只写 tail_，
+// 两端均无锁、无系统调用、无内存分配；所有帧槽在构造时一次性分配。
+class FrameRing {
+ public:
+  // capacity 向上取整为 2 的幂；frame_size 为每帧的 double 个数。
+  FrameRing(int capacity, int frame_size)
+      : frame_size_(frame_size > 0 ? frame_size : 1) {
+    uint64_t n = 1;
+    while (n < static_cast<uint64_t>(capacity > 1 ? capacity : 1)) n <<= 1;
+    capacity_ = n;
+    slots_.assign(capacity_ * frame_size_, 0.0);
+  }
+
+  FrameRing(const FrameRing&) = delete;
+  FrameRing& operator=(const FrameRing&) = delete;
+
+  int capacity() const { return static_cast<int>(capacity_); }
+  int frame_size() const { return frame_size_; }
+
+  // ---- 生产者端 ----
+  // 返回下一个空闲帧槽；环满时返回 nullptr。
+  double* TryAcquire() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ >= capacity_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ >= capacity_) return nullptr;
+    }
+    return Slot(head);
+  }
+
+  // 发布 TryAcquire 返回的帧槽。
+  void Publish() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // ---- 消费者端 ----
+  // 返回最早一帧；环空时返回 nullptr。
+  const double* TryPeek() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) return nullptr;
+    }
+    return Slot(tail);
+  }
+
+  // 归还 TryPeek 返回的帧槽。
+  void Release() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+ private:
+  double* Slot(uint64_t index) {
+    return slots_.data() + (index & (capacity_ - 1)) * frame_size_;
+  }
+
+  // head_/tail_ 分处不同缓存行，避免两线程伪共享。
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;   // 生产者私有：最近一次看到的 tail_
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  uint64_t cached_head_ = 0;   // 消费者私有：最近一次看到的 head_
+
+  alignas(64) uint64_t capacity_ = 1;
+  int frame_size_ = 1;
+  std::vector<double> slots_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_FRAME_RING_H_
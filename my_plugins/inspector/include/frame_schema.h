@@ -0,0 +1,67 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_FRAME_SCHEMA_H_
+#define MUJOCO_PLUGIN_INSPECTOR_FRAME_SCHEMA_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mujoco::plugin::inspector {
+
+// 通道来源。数值写入二进制日志，只能追加，不能改动已有取值。
+enum class ChannelKind : uint8_t {
+  kQpos = 0,            // 关节 qpos，type 为 mjtJoint
+  kQvel = 1,            // 关节 qvel，type 为 mjtJoint
+  kSensor = 2,          // 传感器 sensordata，type 为 mjtSensor
+  kQacc = 3,            // 关节 qacc，type 为 mjtJoint
+  kQfrcActuator = 4,    // 关节 qfrc_actuator，type 为 mjtJoint
+  kNcon = 5,            // 接触数 d->ncon
+  kEnergy = 6,          // d->energy：势能、动能（需开启 energy 标志）
+  kRollout = 7,         // 多路复用日志中的 rollout 编号（见 log_mux.h）
+  kTimer = 8,           // d->timer[i].duration，i 为 mjtTimer，自上次 reset 累计
+  kSolver = 9,          // 约束求解：迭代数、末次 improvement、gradient、岛数
+  kNefc = 10,           // 约束行数 d->nefc
+  kArena = 11,          // 内存高水位：d->maxuse_stack、d->maxuse_arena（字节）
+};
+
+// ChannelKind 的取值个数
+constexpr int kNumChannelKinds = 12;
+
+// 帧内一段连续的 double：名字、来源、类型及其在帧内的位置。
+struct Channel {
+  std::string name;
+  ChannelKind kind = ChannelKind::kQpos;
+  int32_t type = 0;
+  int32_t offset = 0;   // 帧内偏移（frame[0] 恒为 time）
+  int32_t count = 0;    // double 个数
+};
+
+// 一帧的布局。不依赖 mujoco，日志读取端可单独使用。
+struct FrameSchema {
+  std::vector<Channel> channels;
+  int32_t frame_size = 1;   // 每帧 double 数，含 time
+
+  // 在帧尾追加一个通道并返回其偏移。
+  int32_t Append(std::string name, ChannelKind kind, int32_t type,
+                 int32_t count) {
+    channels.push_back({std::move(name), kind, type, frame_size, count});
+    frame_size += count;
+    return channels.back().offset;
+  }
+};
+
+// 是否为按关节登记的通道（qpos/qvel/qacc/qfrc_actuator）。
+inline bool IsJointChannel(ChannelKind kind) {
+  return kind == ChannelKind::kQpos || kind == ChannelKind::kQvel ||
+         kind == ChannelKind::kQacc || kind == ChannelKind::kQfrcActuator;
+}
+
+// 通道来源的短名，用于文本与 CSV 列名，同时也是 fields 属性中的写法：
+// "qpos" / "qvel" / "sensor" / "qacc" / "qfrc_actuator" / "ncon" / "energy" /
+// "timer" / "solver" / "nefc" / "arena"
+// （"rollout" 由复用器添加，不能出现在 fields 中）。
+const char* ChannelKindName(ChannelKind kind);
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_FRAME_SCHEMA_H_
@@ -0,0 +1,72 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_FRAME_WRITER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_FRAME_WRITER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "frame_ring.h"
+
+namespace mujoco::plugin::inspector {
+
+// 写线程落后时的处理策略：
+//   kDrop  - 丢弃新帧并计数（默认，物理线程永不等待）
+//   kBlock - 物理线程自旋让出，直到有空闲帧槽（不丢帧）
+enum class OverflowPolicy { kDrop, kBlock };
+
+// 帧的编码与输出，全部在写线程上调用。
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  // 编码并输出一帧（frame_size 个 double）。
+  virtual void Write(const double* frame) = 0;
+
+  // 队列暂时排空时调用，可在此 fflush。
+  virtual void Flush() = 0;
+
+  // 写线程每轮轮询都调用一次（队列为空时也调用），用于与帧无关的 I/O。
+  virtual void Poll() {}
+
+  // 写线程退出前调用一次；dropped 为累计丢帧数。
+  virtual void Close(uint64_t dropped) { (void)dropped; }
+};
+
+// 物理线程把原始帧写入预分配的 FrameRing，后台写线程负责格式化与 I/O。
+class FrameWriter {
+ public:
+  FrameWriter(std::unique_ptr<FrameSink> sink, int frame_size, int capacity,
+              OverflowPolicy policy);
+
+  // 排空队列、关闭 sink 并回收写线程。
+  ~FrameWriter();
+
+  FrameWriter(const FrameWriter&) = delete;
+  FrameWriter& operator=(const FrameWriter&) = delete;
+
+  // 物理线程：取得一个帧槽。kDrop 下环满时返回 nullptr 并计一次丢帧。
+  double* Acquire();
+
+  // 物理线程：发布 Acquire 返回的帧槽。
+  void Publish() { ring_.Publish(); }
+
+  int frame_size() const { return ring_.frame_size(); }
+
+  // 因写线程落后而丢弃的帧数。
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  void Run();
+
+  std::unique_ptr<FrameSink> sink_;
+  FrameRing ring_;
+  OverflowPolicy policy_;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_FRAME_WRITER_H_
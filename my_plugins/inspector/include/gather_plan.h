@@ -0,0 +1,82 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_GATHER_PLAN_H_
+#define MUJOCO_PLUGIN_INSPECTOR_GATHER_PLAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mujoco/mujoco.h>
+
+#include "frame_schema.h"
+
+namespace mujoco::plugin::inspector {
+
+// 帧采集计划：在 Create 时编译为扁平的 (来源数组, 源地址, 帧内偏移, 个数)
+// 拷贝表，每帧只需顺序执行这些 memcpy，无名字查找、无类型分支、无内存分配。
+class GatherPlan {
+ public:
+  // mjData 中的来源数组
+  enum Source : uint8_t {
+    kQpos = 0,
+    kQvel,
+    kSensordata,
+    kQacc,
+    kQfrcActuator,
+    kEnergy,       // mjData 内联数组 energy[2]
+    kNumSources
+  };
+
+  // 在 schema 末尾追加一个通道，并登记从 source[adr, adr+count) 拷贝。
+  // 与上一条源、目标都连续的拷贝会合并为一条。
+  void Add(FrameSchema* schema, std::string name, ChannelKind kind,
+           int32_t type, Source source, int adr, int count);
+
+  // 在 schema 末尾追加一个单值通道，取自 mjData 中偏移为 offset 的 int
+  // 成员（如 offsetof(mjData, ncon)），按 double 存入帧。
+  void AddInt(FrameSchema* schema, std::string name, ChannelKind kind,
+              size_t offset);
+
+  // 运行时遥测：不是连续的 mjtNum 数组，需要逐项读取或归约
+  enum Telemetry : uint8_t {
+    kTimer,    // mjNTIMER 个 d->timer[i].duration
+    kSolver,   // 4 个：各岛最大迭代数、末次 improvement 与 gradient 的最大值、
+               //       求解的岛数
+    kArena,    // 2 个：d->maxuse_stack、d->maxuse_arena
+  };
+
+  // 在 schema 末尾追加一个遥测通道（kind 为对应的 ChannelKind）。
+  void AddTelemetry(FrameSchema* schema, std::string name, ChannelKind kind,
+                    Telemetry what);
+
+  // 把 d 的当前状态写入 frame（schema.frame_size 个 double）。
+  void Gather(const mjData* d, double* frame) const;
+
+  // 合并后的拷贝条数。
+  int size() const {
+    return static_cast<int>(ops_.size() + int_ops_.size() +
+                            telemetry_ops_.size());
+  }
+
+ private:
+  struct Op {
+    Source source;
+    int src;     // 来源数组内地址
+    int dst;     // 帧内偏移
+    int count;
+  };
+  struct IntOp {
+    size_t offset;   // mjData 内字节偏移
+    int dst;
+  };
+  struct TelemetryOp {
+    Telemetry what;
+    int dst;
+  };
+  std::vector<Op> ops_;
+  std::vector<IntOp> int_ops_;
+  std::vector<TelemetryOp> telemetry_ops_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_GATHER_PLAN_H_
@@ -1,43 +1,145 @@
 #ifndef MUJOCO_PLUGIN_INSPECTOR_H_
 #define MUJOCO_PLUGIN_INSPECTOR_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 #include <mujoco/mujoco.h>
 
+#include "frame_schema.h"
+#include "frame_writer.h"
+#include "gather_plan.h"
+#include "log_mux.h"
+#include "shm_publisher.h"
+#include "trigger.h"
+
 namespace mujoco::plugin::inspector {
 
-// 配置：mode=print(默认)/file，file=输出路径，rate=Hz（默认 10Hz）
+// 配置：mode=print(默认)/file/binary/compressed/none，file=输出路径，rate=Hz（默认 10Hz）
+// queue=异步队列帧数（默认 1024），policy=drop(默认)/block：写线程落后时丢帧或等待
+// include/exclude=通道选择模式（见 channel_filter.h），
+// fields=记录的字段（默认 "qpos qvel"）：关节字段 qpos/qvel/qacc/qfrc_actuator
+//        作用于每个选中关节，全局字段 ncon/energy 每帧各记一份。
+//        字段对 include/exclude 选中的所有关节统一生效，不能按通道分别指定；
+//        需要不同字段组合时，用多个插件实例各自配置 include 与 fields。
+//        采集在被动力阶段进行，此时执行器、加速度与约束阶段尚未运行：
+//        qacc、qfrc_actuator 与 energy[1]（动能）是上一步的值，
+//        qpos、qvel、ncon、energy[0]（势能）是本步的值。
+//        运行时遥测也是全局字段：timer=各阶段 d->timer[].duration（自上次 reset
+//        累计，相邻帧相减即区间耗时；需要宿主设置 mjcb_time，否则恒为 0），
+//        solver=迭代数/improvement/gradient/岛数，nefc=约束行数，
+//        arena=maxuse_stack/maxuse_arena 高水位。插件在被动力阶段调用，
+//        本步的约束求解尚未进行：solver 为上一步的结果，timer 相邻帧之差
+//        的区间也以此为界（上一步的后半加本步的前半）；ncon、nefc 已是本步的值
+// capture=continuous(默认)/trigger：trigger 时平时只在内存中保留最近
+//        pretrigger 秒（默认 2）的帧，trigger 条件（见 trigger.h）成立后
+//        写出这段历史，并继续记录 posttrigger 秒（默认 1）
+// block=mode=compressed 时每块的帧数（默认 256，见 log_codec.h），
+//        压缩在写线程上完成，未满的块在关闭时写出
+// shm=共享内存段名（如 "/mj_inspector"）：每步把选中通道发布为最新快照，
+//        读者见 shm_reader.h；可与 mode=none 配合只发布不写日志。同一进程
+//        内段名只能被一个实例使用，并行 rollout 须各配一个名字
+// socket=Unix 域套接字路径：在独立写线程上运行流式服务器（协议见
+//        stream_protocol.h），物理线程按 stream_rate Hz（默认 100，0 为每步）
+//        把帧放入环形队列；客户端各自订阅频率与通道，每个客户端的发送队列
+//        为 stream_queue 帧（默认 256），读得慢时丢弃最旧的帧
+// stats=窗口秒数：日志不再记录原始帧，改为每个窗口输出一条统计摘要
+//        （见 online_stats.h），统计在写线程上完成；按 rate 采样（rate=0 为每步），
+//        要求不漏样本时配合 policy=block。stats_bins=直方图桶数（默认 64），
+//        stats_quantiles=分位数列表（默认 "0.5 0.9 0.99"）
+// install_timer=true：fields 含 timer 且宿主未设置 mjcb_time 时，安装一个
+//        进程全局的毫秒单调时钟（会给出警告，影响进程内所有模型的 d->timer）；
+//        最后一个安装它的实例销毁时恢复。默认 false，不改动全局回调
+// multiplex=true：并行 rollout（同一模型的多个 mjData）共用同一日志输出，
+//        进程内同一路径只打开一次，由一个写线程批量写出（见 log_mux.h）；
+//        每帧末尾多一个 rollout 通道标明来源。各 rollout 的 mode、通道选择
+//        须一致；不能与 stats 同用
 struct InspectorConfig {
   std::optional<std::string> mode;
   std::optional<std::string> file;
+  std::optional<std::string> shm;
+  std::optional<std::string> socket;
+  double stream_rate_hz = 100.0;
+  int stream_queue_frames = 256;
   double rate_hz = 10.0;
+  int queue_frames = 1024;
+  int block_frames = 256;
+  OverflowPolicy policy = OverflowPolicy::kDrop;
+  std::string include;
+  std::string exclude;
+  std::vector<ChannelKind> fields = {ChannelKind::kQpos, ChannelKind::kQvel};
+  bool triggered = false;
+  std::string trigger;
+  double pretrigger = 2.0;
+  double posttrigger = 1.0;
+  double stats_window = 0.0;     // 0 表示记录原始帧
+  int stats_bins = 64;
+  std::vector<double> stats_quantiles = {0.5, 0.9, 0.99};
+  bool multiplex = false;
+  bool install_timer = false;
 };
 
 class Inspector {
  public:
   static std::unique_ptr<Inspector> Create(const mjModel* m, int instance);
+  ~Inspector();
 
   void Compute(const mjModel* m, mjData* d, int instance);
 
+  // mj_resetData 时调用：结束正在记录的触发窗口。插件 reset 拿不到
+  // mjData，且此时 d->warning 已被清零，触发前历史留到下一次 Compute：
+  // 发散导致的自动复位（见 AutoResetWarned）作为触发写出，否则清空。
+  void Reset();
+
+  // 因写线程落后而丢弃的帧数（policy=drop 时）
+  uint64_t dropped() const {
+    return writer_ ? writer_->dropped() : rollout_ ? rollout_->dropped() : 0;
+  }
+
+  // multiplex=true 时本 mjData 的 rollout 编号，否则为 -1
+  int rollout() const { return rollout_ ? rollout_->id() : -1; }
+
+  // capture=trigger 时的触发次数，及最近一次成立的条件
+  int triggers() const { return triggers_; }
+  const std::string& last_trigger() const { return last_trigger_; }
+
   static void RegisterPlugin();
 
  private:
-  explicit Inspector(InspectorConfig config, void* file_handle);
+  Inspector(InspectorConfig config, GatherPlan plan,
+            std::unique_ptr<FrameWriter> writer);
 
-  void EmitHeaderOnce(const mjModel* m);
-  void EmitJoints(const mjModel* m, const mjData* d);
-  void EmitSensors(const mjModel* m, const mjData* d);
-  void EmitLine(const std::string& line);
+  // 日志帧槽的取得与发布，转给 writer_ 或 rollout_
+  double* AcquireLogFrame();
+  void PublishLogFrame();
+
+  // 按采集计划把当前状态拷入一个帧槽
+  void CaptureFrame(const mjData* d);
+
+  // 把触发前历史按时间顺序送入写线程并清空
+  void FlushHistory();
 
   InspectorConfig config_;
-  void* file_ = nullptr;     // FILE*，仅当 mode==file 时使用
-  bool header_emitted_ = false;
+  GatherPlan plan_;                       // Create 时编译，之后只读
+  std::unique_ptr<FrameWriter> writer_;   // 格式化与 I/O 都在其写线程上；mode=none 时为空
+  std::unique_ptr<LogMux::Rollout> rollout_;  // multiplex=true 时取代 writer_
+  std::unique_ptr<ShmPublisher> shm_;     // shm 未配置时为空
+  std::unique_ptr<FrameWriter> stream_;   // 流式服务器运行在其写线程上；socket 未配置时为空
   double last_emit_time_ = -1.0;
+  double last_stream_time_ = -1.0;
+  bool owns_timer_ = false;               // 持有 install_timer 安装的 mjcb_time
+
+  // capture=trigger
+  std::optional<Trigger> trigger_;
+  std::unique_ptr<FrameHistory> history_;
+  double post_end_ = -1.0;                // 触发窗口结束时刻，-1 表示未触发
+  bool reset_pending_ = false;            // Reset 之后尚未执行 Compute
+  int triggers_ = 0;
+  std::string last_trigger_;
 };
 
 }  // namespace mujoco::plugin::inspector
 
 #endif  // MUJOCO_PLUGIN_INSPECTOR_H_
-
@@ -0,0 +1,140 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_LOG_CODEC_H_
+#define MUJOCO_PLUGIN_INSPECTOR_LOG_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+#include "log_format.h"
+
+namespace mujoco::plugin::inspector {
+
+// 压缩日志（mode="compressed"）布局，本机字节序，无外部依赖，逐位无损：
+//
+//   文件头   与二进制日志相同（log_format.h），version = kLogVersionCompressed
+//   块       uint32 kBlockMarker, uint32 nframe, uint32 nbytes, 负载[nbytes]
+//   索引     uint32 kIndexMarker, uint32 nblock,
+//            nblock 个 {uint64 文件偏移, double 首帧时刻, uint32 nframe, uint32 0}
+//   尾部     uint64 索引偏移, char magic[8] = "MJINSPX"
+//
+// 每块至多 block_frames 帧，独立编码，可经索引直接定位。进程中途退出时
+// 没有索引与尾部，已写完的块仍可顺序读出（未满的最后一块丢失）。
+//
+// 块负载为按列排列的位流（高位在前）：
+//   time     首值 64 位原样；之后对位模式（视为整数）做二阶差分，
+//            按大小用 0 / 10+7 / 110+9 / 1110+12 / 11110+32 / 11111+64 位编码。
+//            固定步长下二阶差分几乎总为 0 或 ±1，每帧约 1~9 位。
+//   整数通道 ncon 等：每值 1 位标志，0 + 与上一值之差的 zigzag varint，
+//            1 + 64 位原样（非整数值时的退路）。
+//   其余通道 Gorilla XOR：与预测值的位模式异或，0 表示相同；否则沿用上一个
+//            前导零/尾随零窗口（10 + 有效位），或给出新窗口
+//            （11 + 5 位前导零 + 6 位有效位数 + 有效位）。
+//            每列 2 位选择预测：0 为上一值，1 为线性外推，2 为二次外推
+//            （外推结果非有限时退回上一值），编码端按实际位数择优。
+
+inline constexpr uint32_t kBlockMarker = 0x4b424a4d;   // "MJBK"
+inline constexpr uint32_t kIndexMarker = 0x58494a4d;   // "MJIX"
+inline constexpr char kLogTrailerMagic[8] = {'M', 'J', 'I', 'N', 'S', 'P', 'X', '\0'};
+
+struct BlockIndexEntry {
+  uint64_t offset;    // 块头在文件中的偏移
+  double time;        // 块内首帧时刻
+  uint32_t nframe;
+  uint32_t reserved;
+};
+
+// 把帧缓冲成块并编码。
+class BlockEncoder {
+ public:
+  BlockEncoder(const FrameSchema& schema, int block_frames);
+
+  // 追加一帧；块满时编码并返回 true，编码结果见 payload()。
+  bool Add(const double* frame);
+
+  // 编码未满的块；没有缓冲帧时返回 false。
+  bool Finish();
+
+  // 最近一次编码的块：负载、帧数与首帧时刻。
+  const std::string& payload() const { return payload_; }
+  int nframe() const { return encoded_frames_; }
+  double time() const { return encoded_time_; }
+
+ private:
+  void Encode();
+
+  int frame_size_;
+  int block_frames_;
+  std::vector<uint8_t> integer_;   // 每个分量是否为整数通道
+  std::vector<double> frames_;     // 当前块，按帧排列
+  int nframe_ = 0;
+  std::string payload_;
+  int encoded_frames_ = 0;
+  double encoded_time_ = 0.0;
+};
+
+// 解码 BlockEncoder 产生的块负载。
+class BlockDecoder {
+ public:
+  explicit BlockDecoder(const FrameSchema& schema);
+
+  // 把 nframe 帧解码到 frames（nframe × frame_size，按帧排列）。
+  bool Decode(const char* data, size_t size, int nframe,
+              std::vector<double>* frames, std::string* error) const;
+
+ private:
+  int frame_size_;
+  std::vector<uint8_t> integer_;
+};
+
+// 压缩日志的块写出，文件头由调用者先以 compressed=true 写入。
+class CompressedLogWriter {
+ public:
+  CompressedLogWriter(std::FILE* file, const FrameSchema& schema,
+                      int block_frames);
+
+  // 追加一帧，块满时写出。I/O 失败返回 false。
+  bool Add(const double* frame);
+
+  // 写出最后一块、索引与尾部。
+  bool Finish();
+
+ private:
+  bool WriteBlock();
+
+  std::FILE* file_;
+  BlockEncoder encoder_;
+  std::vector<BlockIndexEntry> index_;
+};
+
+// 压缩日志的块读取，文件位置须紧接文件头。
+class CompressedLogReader {
+ public:
+  CompressedLogReader(std::FILE* file, const FrameSchema& schema);
+
+  // 读下一帧；遇到索引、文件结束或块损坏时返回 false。
+  bool Next(double* frame);
+
+  // 经文件尾的索引定位到包含 time 的块的首帧；无索引时返回 false。
+  bool Seek(double time);
+
+  const std::string& error() const { return error_; }
+
+ private:
+  bool ReadBlock();
+
+  std::FILE* file_;
+  int frame_size_;
+  BlockDecoder decoder_;
+  std::vector<double> frames_;   // 当前块的已解码帧
+  int nframe_ = 0;
+  int cursor_ = 0;
+  std::string payload_;
+  std::string error_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_LOG_CODEC_H_
@@ -0,0 +1,52 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_LOG_FORMAT_H_
+#define MUJOCO_PLUGIN_INSPECTOR_LOG_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+
+#include "frame_schema.h"
+
+namespace mujoco::plugin::inspector {
+
+// 二进制日志（mode="binary"）布局，全部为本机字节序：
+//
+//   文件头   char magic[8] = "MJINSPB"
+//            uint32 version
+//            uint32 byte_order = 0x01020304（读取端据此拒绝字节序不符的文件）
+//            uint32 frame_size（每帧 double 数，含 time）
+//            uint32 nchannel
+//   通道表   nchannel 个：uint8 kind, uint8 0, uint16 name_len,
+//            int32 type, int32 offset, int32 count, char name[name_len]
+//   帧       frame_size 个 double，frame[0] 为 time；直到文件末尾
+//
+// 名字、类型等只在文件头写一次，每帧就是原始数据的直接拷贝。
+// version 为 kLogVersionCompressed 时文件头之后是压缩块（见 log_codec.h）。
+
+inline constexpr char kLogMagic[8] = {'M', 'J', 'I', 'N', 'S', 'P', 'B', '\0'};
+inline constexpr uint32_t kLogVersion = 1;
+inline constexpr uint32_t kLogVersionCompressed = 2;
+inline constexpr uint32_t kLogByteOrder = 0x01020304;
+
+// 文件头与通道表的字节串；共享内存段（shm_layout.h）中也存放同样的内容。
+std::string EncodeLogHeader(const FrameSchema& schema,
+                            bool compressed = false);
+
+// 写文件头与通道表，失败返回 false。
+bool WriteLogHeader(std::FILE* file, const FrameSchema& schema,
+                    bool compressed = false);
+
+// 读文件头与通道表。失败时返回 nullopt，并在 error 非空时写入原因。
+// compressed 非空时也接受压缩日志，并写入文件是否压缩；为空时只接受原始帧。
+std::optional<FrameSchema> ReadLogHeader(std::FILE* file, std::string* error,
+                                         bool* compressed = nullptr);
+
+// 同 ReadLogHeader，从内存 data[0, size) 解析。
+std::optional<FrameSchema> DecodeLogHeader(const char* data, size_t size,
+                                           std::string* error);
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_LOG_FORMAT_H_
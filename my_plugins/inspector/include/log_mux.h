@@ -0,0 +1,118 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_LOG_MUX_H_
+#define MUJOCO_PLUGIN_INSPECTOR_LOG_MUX_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame_ring.h"
+#include "frame_schema.h"
+#include "frame_writer.h"
+
+namespace mujoco::plugin::inspector {
+
+// 进程内按输出路径共享的日志复用器（multiplex=true）。
+//
+// 同一 mjModel 上并行的多个 mjData（rollout）各自初始化插件，若各自打开
+// 同一文件，彼此会截断、覆盖。复用器让一个路径在进程内只打开一次：
+// 每个 rollout 有自己的 SPSC 帧环，物理线程照旧无锁写入；一个写线程
+// 轮流排空全部帧环，批量写入同一个 FrameSink，每轮只 Flush 一次。
+// 文件句柄与写线程数不随 rollout 数增长。
+//
+// 日志帧在采集帧之后多一个 rollout 通道（ChannelKind::kRollout），值为
+// 该路径上按接入顺序分配的编号，从 0 开始，不复用。同一 rollout 的帧按
+// 时间顺序出现；不同 rollout 的帧交错，每轮按 rollout 成段写出。
+class LogMux {
+  struct Stream;
+
+ public:
+  // 打开输出；只在某路径的第一个 rollout 接入时调用。失败时返回 nullptr
+  // 并写入 error。
+  using SinkFactory =
+      std::function<std::unique_ptr<FrameSink>(std::string* error)>;
+
+  // 一个 rollout 的写入端，只由一个物理线程使用。析构即退出复用器，
+  // 已发布的帧仍会写出；最后一个 rollout 退出时排空队列并关闭输出。
+  class Rollout {
+   public:
+    ~Rollout();
+
+    Rollout(const Rollout&) = delete;
+    Rollout& operator=(const Rollout&) = delete;
+
+    int id() const;
+
+    // 取得一个日志帧槽，末尾的 rollout 通道已经填好，调用方只需写入前
+    // frame_size()-1 个 double。语义同 FrameWriter::Acquire。
+    double* Acquire();
+    void Publish();
+
+    // 日志帧长（含 rollout 通道）
+    int frame_size() const;
+
+    // 本 rollout 因写线程落后而丢弃的帧数
+    uint64_t dropped() const;
+
+   private:
+    friend class LogMux;
+    Rollout(std::shared_ptr<LogMux> mux, std::shared_ptr<Stream> stream);
+
+    std::shared_ptr<LogMux> mux_;
+    std::shared_ptr<Stream> stream_;
+  };
+
+  // 接入 key（通常为输出路径）对应的复用器，不存在时新建并调用 open_sink。
+  // schema 为日志帧布局，末尾须为 rollout 通道；同一 key 上的 format（如
+  // mode 取值）与 schema 必须一致，否则返回 nullptr 并写入 error。
+  // capacity、policy 为本 rollout 帧环的帧数与溢出策略。
+  static std::unique_ptr<Rollout> Attach(const std::string& key,
+                                         const std::string& format,
+                                         const FrameSchema& schema,
+                                         int capacity, OverflowPolicy policy,
+                                         const SinkFactory& open_sink,
+                                         std::string* error);
+
+  // 排空所有帧环、关闭 sink 并回收写线程。
+  ~LogMux();
+
+  LogMux(const LogMux&) = delete;
+  LogMux& operator=(const LogMux&) = delete;
+
+ private:
+  struct Stream {
+    Stream(int id, int capacity, int frame_size, OverflowPolicy policy)
+        : ring(capacity, frame_size), id(id), policy(policy) {}
+
+    FrameRing ring;
+    int id;
+    OverflowPolicy policy;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> closed{false};   // rollout 已退出，排空后移除
+  };
+
+  LogMux(std::string format, FrameSchema schema,
+         std::unique_ptr<FrameSink> sink);
+
+  void Run();
+
+  const std::string format_;
+  const FrameSchema schema_;
+  std::unique_ptr<FrameSink> sink_;   // 只在写线程上访问
+
+  std::mutex mutex_;                  // 保护 streams_ 与 next_id_
+  std::vector<std::shared_ptr<Stream>> streams_;
+  int next_id_ = 0;
+
+  uint64_t retired_dropped_ = 0;      // 已移除 rollout 的丢帧数，写线程私有
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_LOG_MUX_H_
@@ -0,0 +1,64 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_LOG_READER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_LOG_READER_H_
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+
+namespace mujoco::plugin::inspector {
+
+class CompressedLogReader;
+
+// 二进制日志读取器（格式见 log_format.h），不依赖 mujoco。
+// 压缩日志（log_codec.h）同样支持，逐块解码后按帧给出。
+// 文本日志（mode="print"/"file" 的输出）也可读取：通道表取自首帧的
+// J/S/F 行，通道类型未知时为 0；文本中的数值只保留 6 位小数。
+class LogReader {
+ public:
+  // 打开并解析文件头；失败返回 nullptr，并在 error 非空时写入原因。
+  static std::unique_ptr<LogReader> Open(const std::string& path,
+                                         std::string* error = nullptr);
+  ~LogReader();
+
+  LogReader(const LogReader&) = delete;
+  LogReader& operator=(const LogReader&) = delete;
+
+  const FrameSchema& schema() const { return schema_; }
+
+  // 读下一帧到 frame（schema().frame_size 个 double）。
+  // 文件结束或末帧不完整（例如进程中途退出）时返回 false。
+  bool Next(double* frame);
+
+  bool compressed() const { return compressed_ != nullptr; }
+  bool text() const { return text_; }
+
+  // 定位到帧时刻不晚于 time 的最后一帧（time 早于首帧时为首帧），
+  // 之后 Next 从该帧读起。要求帧时刻单调递增。
+  // 原始帧日志按帧长二分查找，压缩日志经块索引定位到块首帧；
+  // 文本日志或压缩日志没有索引（进程中途退出）时返回 false。
+  bool Seek(double time);
+
+ private:
+  LogReader(std::FILE* file, FrameSchema schema);
+
+  // 文本日志：读一帧的全部数值；channels 非空时同时登记通道
+  bool ReadTextFrame(std::vector<double>* values,
+                     std::vector<Channel>* channels);
+
+  std::FILE* file_;
+  FrameSchema schema_;
+  std::unique_ptr<CompressedLogReader> compressed_;
+  long data_offset_ = 0;             // 原始帧日志首帧的文件偏移
+
+  bool text_ = false;
+  std::string line_;                 // 文本日志：已读入、属于下一帧的 "t=" 行
+  std::vector<double> first_frame_;  // 文本日志：解析通道表时读出的首帧
+  bool first_pending_ = false;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_LOG_READER_H_
@@ -0,0 +1,110 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_LOG_REPLAY_H_
+#define MUJOCO_PLUGIN_INSPECTOR_LOG_REPLAY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <mujoco/mujoco.h>
+
+#include "log_reader.h"
+
+namespace mujoco::plugin::inspector {
+
+// 按记录的帧回放 mjData：不做动力学积分，只写入 time/qpos/qvel 后调用
+// mj_kinematics 或 mj_forward，远快于重新仿真。二进制或压缩日志的帧时刻上，
+// qpos/qvel 及由其算出的位姿与原始运行逐位一致，不受模型参数或积分器改动影响。
+//
+// 日志可为文本、二进制或压缩格式（见 LogReader）。qpos/qvel 通道按关节名
+// 对应到模型；日志中没有的关节保持 qpos0、速度为 0。
+// 内存中只保留当前时刻两侧的两帧，回放时长不受内存限制。
+// 多路复用日志（multiplex=true，见 log_mux.h）一次只回放其中一个 rollout。
+//
+//   auto replay = LogReplay::Open(m, "run.binz", &error);
+//   for (double t = replay->start_time(); replay->Apply(t, d); t += 1.0/60) {
+//     ... 渲染或分析 d ...
+//   }
+class LogReplay {
+ public:
+  // Apply 之后执行的计算
+  enum class Stage {
+    kKinematics,   // mj_kinematics：位姿，足够渲染与几何分析
+    kForward,      // mj_forward：另含接触、传感器、加速度等
+  };
+
+  // 打开日志并按关节名建立通道映射。日志为空、或没有任何 qpos 通道能对应
+  // 到模型时返回 nullptr，并写入 error。
+  // rollout 选择多路复用日志中回放的 rollout，-1 为首帧所属的 rollout；
+  // 普通日志忽略此参数。
+  static std::unique_ptr<LogReplay> Open(const mjModel* m,
+                                         const std::string& path,
+                                         std::string* error,
+                                         int rollout = -1);
+
+  LogReplay(const LogReplay&) = delete;
+  LogReplay& operator=(const LogReplay&) = delete;
+
+  // 首帧时刻
+  double start_time() const { return start_time_; }
+
+  // 回放的 rollout 编号；普通日志为 -1
+  int rollout() const { return rollout_; }
+
+  // 对应到模型的关节数，及因名字或维数不符而忽略的 qpos/qvel 通道数
+  int mapped_joints() const { return mapped_joints_; }
+  int ignored_channels() const { return ignored_channels_; }
+
+  // 是否在相邻两帧间插值（默认是）；否则取不晚于 time 的最近一帧。
+  void set_interpolate(bool interpolate) { interpolate_ = interpolate; }
+
+  // 把时刻 time 的状态写入 d 并执行 stage。
+  // 插值时 qpos 沿关节流形（mj_differentiatePos / mj_integratePos，
+  // 球关节与自由关节的四元数随之正确插值），qvel 线性插值。
+  // time 早于当前位置，或超出下一帧约一个块（256 帧）以上时，二进制
+  // 与压缩日志经 LogReader::Seek 直接定位；文本日志、多路复用日志与缺索引
+  // 的压缩日志不能定位，向后时从头读起，向前时逐帧读过去。
+  // time 超过末帧时写入末帧状态并返回 false。
+  bool Apply(double time, mjData* d, Stage stage = Stage::kKinematics);
+
+ private:
+  // 帧内通道到模型地址的映射
+  struct Copy {
+    int offset;   // 帧内偏移
+    int adr;      // qpos 或 qvel 地址
+    int count;
+  };
+
+  // 一帧解出的完整状态
+  struct State {
+    double time = 0.0;
+    std::vector<mjtNum> qpos;
+    std::vector<mjtNum> qvel;
+  };
+
+  LogReplay(const mjModel* m, std::string path, int rollout);
+
+  bool Load(std::string* error);
+  bool Read(State* state);    // 读下一帧（所选 rollout）；日志结束时返回 false
+  bool Seek(double time);     // 重新定位，使 prev_ 不晚于 time
+
+  const mjModel* m_;
+  std::string path_;
+  std::unique_ptr<LogReader> reader_;
+  std::vector<Copy> qpos_copy_;
+  std::vector<Copy> qvel_copy_;
+  std::vector<double> frame_;
+  std::vector<mjtNum> dq_;      // 插值用的 qpos 差分（nv）
+  int rollout_offset_ = -1;     // rollout 通道的帧内偏移；普通日志为 -1
+  int rollout_;
+  bool seekable_ = false;       // reader_ 可按时刻定位
+
+  State prev_, next_;           // prev_.time <= 当前时刻 < next_.time
+  bool has_next_ = false;
+  double start_time_ = 0.0;
+  int mapped_joints_ = 0;
+  int ignored_channels_ = 0;
+  bool interpolate_ = true;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_LOG_REPLAY_H_
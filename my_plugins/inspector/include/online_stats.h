@@ -0,0 +1,67 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_ONLINE_STATS_H_
+#define MUJOCO_PLUGIN_INSPECTOR_ONLINE_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+
+namespace mujoco::plugin::inspector {
+
+// 按时间窗口对帧内每个分量做在线统计，每个窗口只输出一条摘要。
+//
+// 每个分量维护 Welford 均值/方差、最小/最大值，以及一个自动扩展量程的
+// 定长直方图（bins 个桶）：样本落在量程外时量程加倍、相邻桶两两合并，
+// 分位数误差不超过一个桶宽（量程 / bins）。非有限值（NaN、inf）不计入。
+//
+// 摘要本身也是一帧，布局由 summary_schema() 描述：
+//   frame[0] 为窗口起始时刻，之后按统计量分组，每组依次包含原帧的全部通道，
+//   通道名为 "<原通道名>/<统计量>"，来源与类型不变。统计量依次为
+//   count mean std rms min max 及各分位数 p<100q>（如 p50、p99.9）。
+// std 为总体标准差；窗口内某分量没有有效样本时，其统计量为 NaN（count 为 0）。
+class OnlineStats {
+ public:
+  // window 为窗口长度（秒，按帧时刻划分）；bins 向上取为偶数；
+  // quantiles 取值在 (0, 1) 内。
+  OnlineStats(const FrameSchema& schema, double window, int bins,
+              std::vector<double> quantiles);
+
+  const FrameSchema& summary_schema() const { return summary_schema_; }
+
+  // 累加一帧。若该帧开启了新窗口（超出窗口长度，或时刻回退），
+  // 先把上一窗口的摘要写入 summary 并返回 true。
+  bool Add(const double* frame, double* summary);
+
+  // 把当前未结束窗口的摘要写入 summary 并清空；窗口为空时返回 false。
+  bool Finish(double* summary);
+
+ private:
+  void Clear();
+  void Summarize(double* summary) const;
+  void Bin(int i, double x);
+  double Quantile(int i, double q) const;
+
+  int ncomp_;                 // 每帧的分量数（不含 time）
+  int bins_;
+  double window_;
+  std::vector<double> quantiles_;
+  FrameSchema summary_schema_;
+
+  double start_ = 0.0;        // 当前窗口起始时刻
+  int64_t frames_ = 0;        // 当前窗口已累加的帧数
+
+  // 按统计量分开存放（SoA），每帧一次顺序扫描
+  std::vector<int64_t> count_;
+  std::vector<double> mean_;
+  std::vector<double> m2_;
+  std::vector<double> min_;
+  std::vector<double> max_;
+  std::vector<double> lo_;        // 直方图量程下界
+  std::vector<double> width_;     // 桶宽，0 表示目前只见过一个取值
+  std::vector<uint32_t> hist_;    // ncomp_ × bins_
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_ONLINE_STATS_H_
@@ -0,0 +1,42 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_SHM_LAYOUT_H_
+#define MUJOCO_PLUGIN_INSPECTOR_SHM_LAYOUT_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace mujoco::plugin::inspector {
+
+// 共享内存快照段（shm="<name>"）布局，本机字节序：
+//
+//   [0, sizeof(ShmHeader))           ShmHeader
+//   [schema_offset, +schema_size)    通道表，与二进制日志文件头相同
+//                                    （EncodeLogHeader / DecodeLogHeader）
+//   [frame_offset, +8*frame_size)    最新一帧，frame[0] 为 time
+//
+// 帧由 seqlock 保护：发布者写帧前把 sequence 加一（变为奇数），写完再加一。
+// 读者在读帧前后各取一次 sequence，两次相等且为偶数时快照一致，否则重读。
+// 发布者从不等待读者，读者数量不限。
+
+inline constexpr char kShmMagic[8] = {'M', 'J', 'I', 'N', 'S', 'H', 'M', '\0'};
+inline constexpr uint32_t kShmVersion = 1;
+
+struct ShmHeader {
+  char magic[8];           // 段初始化完成后最后写入
+  uint32_t version;
+  uint32_t frame_size;     // 帧长（double 个数）
+  uint32_t schema_offset;  // 字节偏移
+  uint32_t schema_size;    // 字节数
+  uint32_t frame_offset;   // 字节偏移，按 64 字节对齐
+  uint32_t writer_pid;
+
+  // seqlock 序号；sequence / 2 为已发布的帧数
+  alignas(64) std::atomic<uint64_t> sequence;
+};
+
+// 跨进程使用要求 64 位原子操作不依赖锁
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory seqlock needs lock-free 64-bit atomics");
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_SHM_LAYOUT_H_
@@ -0,0 +1,60 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_SHM_PUBLISHER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_SHM_PUBLISHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "frame_schema.h"
+#include "shm_layout.h"
+
+namespace mujoco::plugin::inspector {
+
+// POSIX 共享内存快照发布者（布局见 shm_layout.h）。
+// 单写者：只在物理线程上调用 BeginWrite/EndWrite，不做系统调用、不等待。
+class ShmPublisher {
+ public:
+  // 创建（或覆盖）名为 name 的共享内存段；name 形如 "/mj_inspector"。
+  // 本进程内已有同名发布者时失败（并行 rollout 须各用一个名字）。
+  // 失败返回 nullptr，并写入 error。
+  static std::unique_ptr<ShmPublisher> Create(const std::string& name,
+                                              const FrameSchema& schema,
+                                              std::string* error);
+
+  // 解除映射并删除共享内存段名；已映射的读者不受影响。
+  ~ShmPublisher();
+
+  ShmPublisher(const ShmPublisher&) = delete;
+  ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+  // 开始写一帧，返回段内帧地址，调用者直接写入（无额外拷贝）。
+  double* BeginWrite() {
+    uint64_t seq = header_->sequence.load(std::memory_order_relaxed);
+    header_->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return frame_;
+  }
+
+  // 结束写帧，读者此后可见。
+  void EndWrite() {
+    uint64_t seq = header_->sequence.load(std::memory_order_relaxed);
+    header_->sequence.store(seq + 1, std::memory_order_release);
+  }
+
+  const std::string& name() const { return name_; }
+
+ private:
+  ShmPublisher(std::string name, void* base, size_t size);
+
+  std::string name_;
+  void* base_;
+  size_t size_;
+  ShmHeader* header_;
+  double* frame_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_SHM_PUBLISHER_H_
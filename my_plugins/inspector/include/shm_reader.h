@@ -0,0 +1,96 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_SHM_READER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_SHM_READER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "frame_schema.h"
+#include "shm_layout.h"
+
+namespace mujoco::plugin::inspector {
+
+// 共享内存快照读者（布局见 shm_layout.h），不依赖 mujoco，从不阻塞发布者。
+// 发布者在写入中途退出或停顿时读者也不会挂起：等待有上限，超时或发布者
+// 进程已不存在时读取失败。
+//
+// 拷贝读取：
+//   std::vector<double> frame(reader->schema().frame_size);
+//   std::optional<uint64_t> seq = reader->Snapshot(frame.data());
+//   if (!seq) ... 发布者停在写入中途 ...
+//
+// 零拷贝读取：直接读段内帧，最后校验，失败则丢弃结果重读
+//   std::optional<uint64_t> seq;
+//   do {
+//     if (!(seq = reader->TryBeginRead())) break;
+//     x = reader->frame()[offset];
+//   } while (!reader->Validate(*seq));
+class ShmReader {
+ public:
+  // 等待写入完成的默认上限。发布者写一帧只需微秒级，超过它基本可以
+  // 认定发布者停在写入中途。
+  static constexpr std::chrono::milliseconds kReadTimeout{100};
+
+  // 以只读方式映射名为 name 的段；段不存在或尚未初始化完成时返回 nullptr。
+  static std::unique_ptr<ShmReader> Open(const std::string& name,
+                                         std::string* error = nullptr);
+  ~ShmReader();
+
+  ShmReader(const ShmReader&) = delete;
+  ShmReader& operator=(const ShmReader&) = delete;
+
+  const FrameSchema& schema() const { return schema_; }
+
+  // 段内最新一帧（frame_size 个 double），只能在 TryBeginRead/Validate 之间读。
+  const double* frame() const { return frame_; }
+
+  // 当前序号，不等待。序号变化说明有新帧；sequence / 2 为已发布帧数。
+  uint64_t sequence() const {
+    return header_->sequence.load(std::memory_order_acquire);
+  }
+
+  // 等到没有写入进行中，返回此时的序号（偶数）。发布者在 BeginWrite 与
+  // EndWrite 之间退出或停顿时序号一直为奇数：等待超过 timeout，或段头中
+  // 的发布者进程已不存在时放弃，返回 std::nullopt。
+  std::optional<uint64_t> TryBeginRead(
+      std::chrono::nanoseconds timeout = kReadTimeout) const {
+    uint64_t seq = sequence();
+    if (!(seq & 1)) return seq;
+    return WaitForWriter(std::chrono::steady_clock::now() + timeout);
+  }
+
+  // TryBeginRead 之后读到的内容是否一致。
+  bool Validate(uint64_t seq) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header_->sequence.load(std::memory_order_relaxed) == seq;
+  }
+
+  // 拷贝一份一致快照到 out，返回其序号。timeout 内（含校验失败后的
+  // 重读）得不到一致快照时返回 std::nullopt，此时 out 的内容无意义。
+  std::optional<uint64_t> Snapshot(
+      double* out, std::chrono::nanoseconds timeout = kReadTimeout) const;
+
+  // 发布者进程号（段头中的 writer_pid）。
+  uint32_t writer_pid() const { return header_->writer_pid; }
+
+ private:
+  ShmReader(const void* base, size_t size, FrameSchema schema);
+
+  // 让出 CPU 等待序号变为偶数，到 deadline 或发布者进程消失时放弃
+  std::optional<uint64_t> WaitForWriter(
+      std::chrono::steady_clock::time_point deadline) const;
+
+  const void* base_;
+  size_t size_;
+  const ShmHeader* header_;
+  const double* frame_;
+  FrameSchema schema_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_SHM_READER_H_
@@ -0,0 +1,62 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_STREAM_CLIENT_H_
+#define MUJOCO_PLUGIN_INSPECTOR_STREAM_CLIENT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+
+namespace mujoco::plugin::inspector {
+
+// 流式套接字客户端（协议见 stream_protocol.h），不依赖 mujoco，阻塞读取。
+//
+//   auto client = StreamClient::Connect("/tmp/mj_inspector.sock");
+//   client->Subscribe(60, "arm_* *.qvel");
+//   std::vector<double> frame;
+//   while (client->Next(&frame)) { ... client->schema() 描述 frame 的布局 ... }
+class StreamClient {
+ public:
+  // 连接并读取首条通道表；失败返回 nullptr，并在 error 非空时写入原因。
+  static std::unique_ptr<StreamClient> Connect(const std::string& path,
+                                               std::string* error = nullptr);
+  ~StreamClient();
+
+  StreamClient(const StreamClient&) = delete;
+  StreamClient& operator=(const StreamClient&) = delete;
+
+  // 发送订阅命令；patterns 为空白分隔的通配符，空串表示全部通道。
+  // 服务器确认后 Next 会先更新 schema()，之后的帧按新布局给出。
+  bool Subscribe(double rate_hz, const std::string& patterns = "");
+
+  // 当前帧布局：连接时为全部通道，订阅生效后为所订阅的通道。
+  const FrameSchema& schema() const { return schema_; }
+
+  // schema() 的更新次数，连接时为 0，每收到一次通道表加一。
+  int generation() const { return generation_; }
+
+  // 阻塞读到下一帧，frame 被调整为 schema().frame_size。
+  // 连接断开或协议错误时返回 false，原因见 error()。
+  bool Next(std::vector<double>* frame);
+
+  // 最近一次错误：服务器发来的 kStreamError 文本，或连接错误。
+  const std::string& error() const { return error_; }
+
+  int fd() const { return fd_; }
+
+ private:
+  explicit StreamClient(int fd) : fd_(fd) {}
+
+  // 读一条消息；失败时写入 error_ 并返回 false
+  bool ReadMessage(uint32_t* type, std::string* payload);
+
+  int fd_;
+  FrameSchema schema_;
+  int generation_ = 0;
+  std::string error_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_STREAM_CLIENT_H_
@@ -0,0 +1,37 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_STREAM_PROTOCOL_H_
+#define MUJOCO_PLUGIN_INSPECTOR_STREAM_PROTOCOL_H_
+
+#include <cstdint>
+
+namespace mujoco::plugin::inspector {
+
+// Unix 域流式套接字（socket="<path>"）协议，本机字节序。
+//
+// 服务器 → 客户端：消息序列，每条为 StreamMessageHeader + size 字节负载
+//   kStreamSchema  负载为通道表，与二进制日志文件头相同（DecodeLogHeader）。
+//                  连接建立时发送一次（全部通道），之后每次订阅成功再发送
+//                  一次（所订阅的通道，偏移按订阅后的帧重排）。
+//   kStreamFrame   负载为一帧：最近一次 kStreamSchema 的 frame_size 个 double。
+//   kStreamError   负载为错误文本（不含结尾 '\0'），连接保持。
+//
+// 客户端 → 服务器：文本命令，每行一条
+//   subscribe <rate_hz> [pattern ...]
+//     rate_hz 为 0 时接收服务器发出的每一帧；pattern 为 fnmatch 通配符，
+//     匹配通道名或 "<通道名>.<来源>"（如 "arm_*"、"*.qvel"）；省略时订阅全部。
+//
+// 客户端读得慢时，服务器丢弃其发送队列中最旧的帧，不影响其他客户端。
+
+enum StreamMessageType : uint32_t {
+  kStreamSchema = 1,
+  kStreamFrame = 2,
+  kStreamError = 3,
+};
+
+struct StreamMessageHeader {
+  uint32_t type;
+  uint32_t size;   // 负载字节数
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_STREAM_PROTOCOL_H_
@@ -0,0 +1,75 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_STREAM_SERVER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_STREAM_SERVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frame_schema.h"
+#include "frame_writer.h"
+
+namespace mujoco::plugin::inspector {
+
+// Unix 域套接字流式服务器（协议见 stream_protocol.h）。
+// 作为 FrameSink 挂在自己的 FrameWriter 上：监听、accept、收命令、
+// 按订阅裁剪帧与发送全部在写线程上完成，套接字均为非阻塞。
+class StreamServer : public FrameSink {
+ public:
+  // 在 path 上监听（已存在的同名套接字文件会被替换）。
+  // queue_frames 为每个客户端的发送队列帧数。失败返回 nullptr 并写入 error。
+  static std::unique_ptr<StreamServer> Create(const std::string& path,
+                                              const FrameSchema& schema,
+                                              int queue_frames,
+                                              std::string* error);
+  ~StreamServer() override;
+
+  void Write(const double* frame) override;
+  void Flush() override;
+  void Poll() override;
+  void Close(uint64_t dropped) override;
+
+ private:
+  struct Client {
+    int fd = -1;
+    double rate_hz = 0.0;
+    double last_time = -1.0;
+    FrameSchema schema;                         // 订阅后的帧布局
+    std::vector<std::pair<int, int>> gather;    // 源帧 (offset, count)
+    std::string command;                        // 未读完整的命令行
+    std::deque<std::string> queue;              // 待发消息
+    size_t queue_frames = 0;                    // queue 中的帧消息数
+    size_t sent = 0;                            // queue.front() 已发送字节数
+    uint64_t dropped = 0;                       // 因读得慢而丢弃的帧数
+  };
+
+  StreamServer(std::string path, int listen_fd, FrameSchema schema,
+               int queue_frames);
+
+  void Accept();
+  void Receive(Client* client);
+  void Command(Client* client, const std::string& line);
+  void Subscribe(Client* client, const std::vector<std::string>& patterns);
+  // 取一个消息缓冲并写好消息头，负载未初始化
+  std::string NewMessage(uint32_t type, size_t size);
+  // 追加到发送队列；帧消息超出队列上限时丢弃最旧的未发送帧
+  void Enqueue(Client* client, std::string message);
+  void Send(Client* client);
+  void Disconnect(Client* client);
+  void Sweep();    // 移除已断开的客户端
+
+  std::string path_;
+  int listen_fd_;
+  FrameSchema schema_;
+  std::string schema_message_;                  // 全部通道的 kStreamSchema 负载
+  size_t queue_frames_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  std::vector<std::string> spare_;              // 复用的消息缓冲
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_STREAM_SERVER_H_
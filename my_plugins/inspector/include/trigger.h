@@ -0,0 +1,101 @@
+#ifndef MUJOCO_PLUGIN_INSPECTOR_TRIGGER_H_
+#define MUJOCO_PLUGIN_INSPECTOR_TRIGGER_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+#include <mujoco/mujoco.h>
+
+namespace mujoco::plugin::inspector {
+
+// 触发条件：空白分隔的列表，任一条件成立即触发。
+//
+//   nan            qpos、qvel 或 qacc 中出现 NaN/Inf
+//   warning        任一 d->warning[i].number 增加
+//   ncon>N         接触数超过 N
+//   dncon>N        接触数相比上一步增加超过 N（接触突增）
+//   NAME>V NAME<V  传感器 NAME 的第 0 个分量越过阈值 V
+//   NAME[i]>V      同上，第 i 个分量
+//
+// 例：trigger="nan warning dncon>20 foot_force[2]>500"
+//
+// 条件在被动力阶段检查：qacc 为上一步的值；位置阶段的传感器已是本步的值，
+// 速度、加速度阶段的传感器（如 velocimeter、accelerometer、touch）的
+// sensordata 仍是上一步的。
+//
+// 发散时 mj_step 的 mj_checkPos/mj_checkVel/mj_checkAcc 默认会自动
+// mj_resetData，坏值在条件检查之前就被清掉；这种自动复位由 Inspector
+// 按 AutoResetWarned 识别，作为原因为 "reset" 的触发事件处理。
+class Trigger {
+ public:
+  // 解析失败（未知传感器、分量越界、语法错误）时返回 nullopt，并写入 error。
+  static std::optional<Trigger> Parse(const mjModel* m,
+                                      const std::string& spec,
+                                      std::string* error);
+
+  // 每步调用一次。返回成立的条件原文，未触发返回 nullptr。
+  const char* Check(const mjModel* m, const mjData* d);
+
+  // mj_resetData 后调用：计数类条件从 0 重新比较
+  void Reset() { last_warning_ = last_ncon_ = 0; }
+
+ private:
+  struct Condition {
+    enum Type { kNan, kWarning, kNcon, kNconJump, kAbove, kBelow } type;
+    int adr = 0;          // 传感器条件：sensordata 地址
+    double value = 0;     // 阈值
+    std::string text;     // 条件原文
+  };
+
+  std::vector<Condition> conditions_;
+  int last_warning_ = 0;   // 上一步的警告计数总和
+  int last_ncon_ = 0;      // 上一步的接触数
+};
+
+// mj_resetData 会清零 d->warning；自动复位时 mj_check* 在复位之后重新
+// 计入 BADQPOS/BADQVEL/BADQACC。复位后的第一步这些计数非 0，说明这次
+// 复位是发散导致的自动复位，而不是用户调用的 mj_resetData。
+bool AutoResetWarned(const mjData* d);
+
+// 触发前历史：物理线程私有的定长帧环，只保留最近 capacity 帧。
+class FrameHistory {
+ public:
+  FrameHistory(int capacity, int frame_size)
+      : capacity_(capacity > 0 ? capacity : 1), frame_size_(frame_size),
+        frames_(static_cast<size_t>(capacity_) * frame_size) {}
+
+  int capacity() const { return capacity_; }
+  int size() const { return size_; }
+  int frame_size() const { return frame_size_; }
+
+  // 取得下一帧的存储位置，满时覆盖最旧的一帧。
+  double* Push() {
+    double* slot = frames_.data() +
+        static_cast<size_t>((first_ + size_) % capacity_) * frame_size_;
+    if (size_ < capacity_) {
+      ++size_;
+    } else {
+      first_ = (first_ + 1) % capacity_;
+    }
+    return slot;
+  }
+
+  // 第 i 旧的一帧（0 为最旧）。
+  const double* At(int i) const {
+    return frames_.data() +
+        static_cast<size_t>((first_ + i) % capacity_) * frame_size_;
+  }
+
+  void Clear() { first_ = size_ = 0; }
+
+ private:
+  int capacity_;
+  int frame_size_;
+  int first_ = 0;
+  int size_ = 0;
+  std::vector<double> frames_;
+};
+
+}  // namespace mujoco::plugin::inspector
+
+#endif  // MUJOCO_PLUGIN_INSPECTOR_TRIGGER_H_
@@ -0,0 +1,100 @@
+#include "channel_filter.h"
+
+#include <sstream>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 通配符匹配：'*' 匹配任意串（含空串），'?' 匹配任意单字符
+bool GlobMatch(const char* pattern, const char* name) {
+  const char* star = nullptr;  // 最近一次 '*' 的位置
+  const char* retry = nullptr; // '*' 之后重新尝试匹配的位置
+  while (*name) {
+    if (*pattern == '*') {
+      star = pattern++;
+      retry = name;
+    } else if (*pattern == '?' || *pattern == *name) {
+      ++pattern;
+      ++name;
+    } else if (star) {
+      pattern = star + 1;
+      name = ++retry;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*') ++pattern;
+  return *pattern == '\0';
+}
+
+bool StartsWith(const std::string& s, const char* prefix, size_t len) {
+  return s.compare(0, len, prefix) == 0;
+}
+
+}  // namespace
+
+std::optional<ChannelFilter> ChannelFilter::Parse(const std::string& include,
+                                                  const std::string& exclude,
+                                                  std::string* error) {
+  ChannelFilter filter;
+  if (!Compile(include, &filter.include_, error) ||
+      !Compile(exclude, &filter.exclude_, error)) {
+    return std::nullopt;
+  }
+  return filter;
+}
+
+bool ChannelFilter::Compile(const std::string& list,
+                            std::vector<Pattern>* out, std::string* error) {
+  static const char* kObjects[kNumObjects] = {"joint:", "sensor:", "body:"};
+  std::istringstream ss(list);
+  std::string token;
+  while (ss >> token) {
+    Pattern p;
+    for (int i = 0; i < kNumObjects; ++i) {
+      size_t len = std::char_traits<char>::length(kObjects[i]);
+      if (StartsWith(token, kObjects[i], len)) {
+        p.object = i;
+        token.erase(0, len);
+        break;
+      }
+    }
+    if (StartsWith(token, "re:", 3)) {
+      p.regex = true;
+      try {
+        p.re = std::regex(token.substr(3), std::regex::ECMAScript);
+      } catch (const std::regex_error&) {
+        *error = "invalid regex '" + token.substr(3) + "'";
+        return false;
+      }
+    } else {
+      p.glob = token;
+    }
+    out->push_back(std::move(p));
+  }
+  return true;
+}
+
+bool ChannelFilter::Matches(const std::vector<Pattern>& patterns,
+                            Object object, const char* name) {
+  if (!name) name = "";
+  for (const Pattern& p : patterns) {
+    if (p.object >= 0 && p.object != object) continue;
+    if (p.regex ? std::regex_match(name, p.re)
+                : GlobMatch(p.glob.c_str(), name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ChannelFilter::Included(Object object, const char* name) const {
+  return include_.empty() || Matches(include_, object, name);
+}
+
+bool ChannelFilter::Excluded(Object object, const char* name) const {
+  return Matches(exclude_, object, name);
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,59 @@
+#include "frame_writer.h"
+
+#include <chrono>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 队列为空时写线程的轮询间隔。物理线程发布帧时不做任何唤醒操作，
+// 因此这里用短睡眠代替条件变量，生产端保持无锁无系统调用。
+constexpr auto kIdleSleep = std::chrono::microseconds(500);
+
+}  // namespace
+
+FrameWriter::FrameWriter(std::unique_ptr<FrameSink> sink, int frame_size,
+                         int capacity, OverflowPolicy policy)
+    : sink_(std::move(sink)), ring_(capacity, frame_size), policy_(policy) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+FrameWriter::~FrameWriter() {
+  stop_.store(true, std::memory_order_release);
+  if (thread_.joinable()) thread_.join();
+}
+
+double* FrameWriter::Acquire() {
+  double* slot = ring_.TryAcquire();
+  if (slot) return slot;
+  if (policy_ == OverflowPolicy::kDrop) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  // kBlock：等待写线程腾出帧槽，物理线程本身不做 I/O
+  while (!(slot = ring_.TryAcquire())) std::this_thread::yield();
+  return slot;
+}
+
+void FrameWriter::Run() {
+  bool pending = false;   // 自上次 Flush 以来有输出
+  for (;;) {
+    // 先读 stop_ 再排空，保证析构前发布的帧都被写出
+    bool stopping = stop_.load(std::memory_order_acquire);
+    while (const double* frame = ring_.TryPeek()) {
+      sink_->Write(frame);
+      ring_.Release();
+      pending = true;
+    }
+    if (pending) {
+      sink_->Flush();
+      pending = false;
+    }
+    sink_->Poll();
+    if (stopping) break;
+    std::this_thread::sleep_for(kIdleSleep);
+  }
+  sink_->Close(dropped());
+}
+
+}  // namespace mujoco::plugin::inspector
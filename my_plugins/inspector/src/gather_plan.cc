@@ -0,0 +1,93 @@
+#include "gather_plan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+void GatherTelemetry(const mjData* d, GatherPlan::Telemetry what,
+                     double* out) {
+  switch (what) {
+    case GatherPlan::kTimer:
+      for (int i = 0; i < mjNTIMER; ++i) out[i] = d->timer[i].duration;
+      break;
+
+    case GatherPlan::kSolver: {
+      // 各岛的统计分段存放，每岛 mjNSOLVER 条，第 k 条为第 k 次迭代；
+      // 取各岛末次迭代，每项报告所有岛中的最大值
+      int nisland = std::min<int>(std::max(d->solver_nisland, 1), mjNISLAND);
+      int niter = 0;
+      double improvement = 0, gradient = 0;
+      for (int i = 0; i < nisland; ++i) {
+        int n = std::min<int>(d->solver_niter[i], mjNSOLVER);
+        niter = std::max(niter, d->solver_niter[i]);
+        if (n <= 0) continue;
+        const mjSolverStat& last = d->solver[i * mjNSOLVER + n - 1];
+        improvement = std::max(improvement, static_cast<double>(last.improvement));
+        gradient = std::max(gradient, static_cast<double>(last.gradient));
+      }
+      out[0] = niter;
+      out[1] = improvement;
+      out[2] = gradient;
+      out[3] = d->solver_nisland;
+      break;
+    }
+
+    case GatherPlan::kArena:
+      out[0] = static_cast<double>(d->maxuse_stack);
+      out[1] = static_cast<double>(d->maxuse_arena);
+      break;
+  }
+}
+
+}  // namespace
+
+void GatherPlan::Add(FrameSchema* schema, std::string name, ChannelKind kind,
+                     int32_t type, Source source, int adr, int count) {
+  int dst = schema->Append(std::move(name), kind, type, count);
+  if (count <= 0) return;
+  if (!ops_.empty()) {
+    Op& last = ops_.back();
+    if (last.source == source && last.src + last.count == adr &&
+        last.dst + last.count == dst) {
+      last.count += count;
+      return;
+    }
+  }
+  ops_.push_back({source, adr, dst, count});
+}
+
+void GatherPlan::AddInt(FrameSchema* schema, std::string name,
+                        ChannelKind kind, size_t offset) {
+  int dst = schema->Append(std::move(name), kind, 0, 1);
+  int_ops_.push_back({offset, dst});
+}
+
+void GatherPlan::AddTelemetry(FrameSchema* schema, std::string name,
+                              ChannelKind kind, Telemetry what) {
+  int count = what == kTimer ? mjNTIMER : what == kSolver ? 4 : 2;
+  int dst = schema->Append(std::move(name), kind, 0, count);
+  telemetry_ops_.push_back({what, dst});
+}
+
+void GatherPlan::Gather(const mjData* d, double* frame) const {
+  // 以来源编号查表取数组指针，循环体内无分支
+  const mjtNum* source[kNumSources] = {d->qpos, d->qvel, d->sensordata,
+                                       d->qacc, d->qfrc_actuator, d->energy};
+  frame[0] = d->time;
+  for (const Op& op : ops_) {
+    std::memcpy(frame + op.dst, source[op.source] + op.src,
+                sizeof(mjtNum) * op.count);
+  }
+  const char* base = reinterpret_cast<const char*>(d);
+  for (const IntOp& op : int_ops_) {
+    frame[op.dst] = *reinterpret_cast<const int*>(base + op.offset);
+  }
+  for (const TelemetryOp& op : telemetry_ops_) {
+    GatherTelemetry(d, op.what, frame + op.dst);
+  }
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -1,10 +1,27 @@
 #include "inspector.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
+
+#include "channel_filter.h"
+#include "gather_plan.h"
+#include "log_codec.h"
+#include "log_format.h"
+#include "log_mux.h"
+#include "online_stats.h"
+#include "shm_publisher.h"
+#include "stream_server.h"
 
 namespace mujoco::plugin::inspector {
 namespace {
@@ -23,94 +40,683 @@ std::optional<double> ReadDoubleAttr(const mjModel* m, int instance,
   return std::strtod(v, nullptr);
 }
 
+// fields 属性的取值，见 ChannelKindName
+std::optional<ChannelKind> ParseField(const std::string& name) {
+  for (ChannelKind kind : {ChannelKind::kQpos, ChannelKind::kQvel,
+                           ChannelKind::kQacc, ChannelKind::kQfrcActuator,
+                           ChannelKind::kNcon, ChannelKind::kEnergy,
+                           ChannelKind::kTimer, ChannelKind::kSolver,
+                           ChannelKind::kNefc, ChannelKind::kArena}) {
+    if (name == ChannelKindName(kind)) return kind;
+  }
+  return std::nullopt;
+}
+
+// mjcb_time 未设置时 d->timer[].duration 恒为 0。install_timer=true 时装上
+// 一个单调时钟（毫秒，与 simulate 一致）。mjcb_time 是进程全局的，影响宿主中
+// 所有模型，因此只在显式要求时安装，已有回调时不覆盖；最后一个安装者销毁时
+// 恢复为空，避免插件库卸载后留下悬空指针。
+mjtNum SteadyClockMs() {
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point start = Clock::now();
+  return std::chrono::duration<mjtNum, std::milli>(Clock::now() - start)
+      .count();
+}
+
+std::mutex timer_mutex;
+int timer_users = 0;   // 持有本插件时钟的 Inspector 数
+
+// 安装或共用本插件的时钟；已有其他回调时返回 false
+bool AcquireTimerCallback() {
+  std::lock_guard<std::mutex> lock(timer_mutex);
+  if (mjcb_time && mjcb_time != SteadyClockMs) return false;
+  if (!mjcb_time) {
+    mjcb_time = SteadyClockMs;
+    mju_warning("inspector: installed a process-wide mjcb_time "
+                "(steady clock, ms) for field 'timer'");
+  }
+  ++timer_users;
+  return true;
+}
+
+void ReleaseTimerCallback() {
+  std::lock_guard<std::mutex> lock(timer_mutex);
+  if (--timer_users == 0 && mjcb_time == SteadyClockMs) mjcb_time = nullptr;
+}
+
+GatherPlan::Source JointSource(ChannelKind kind) {
+  switch (kind) {
+    case ChannelKind::kQpos: return GatherPlan::kQpos;
+    case ChannelKind::kQvel: return GatherPlan::kQvel;
+    case ChannelKind::kQacc: return GatherPlan::kQacc;
+    default:                 return GatherPlan::kQfrcActuator;
+  }
+}
+
+// 编译采集计划：time | 每个关节字段的各关节数据 | 各传感器 sensordata |
+// 全局字段。关节按 id 顺序登记，地址递增，全选时每个字段合并为一次拷贝。
+// 过滤器只在这里生效，每帧开销只与选中的通道数有关。
+void BuildPlan(const mjModel* m, const InspectorConfig& cfg,
+               const ChannelFilter& filter, FrameSchema* schema,
+               GatherPlan* plan) {
+  std::vector<int> joints;
+  for (int j = 0; j < m->njnt; ++j) {
+    const char* name = mj_id2name(m, mjOBJ_JOINT, j);
+    const char* body = mj_id2name(m, mjOBJ_BODY, m->jnt_bodyid[j]);
+    bool included = filter.Included(ChannelFilter::kJoint, name) ||
+                    filter.Included(ChannelFilter::kBody, body);
+    bool excluded = filter.Excluded(ChannelFilter::kJoint, name) ||
+                    filter.Excluded(ChannelFilter::kBody, body);
+    if (included && !excluded) joints.push_back(j);
+  }
+
+  for (ChannelKind field : cfg.fields) {
+    if (!IsJointChannel(field)) continue;
+    for (int j : joints) {
+      const char* name = mj_id2name(m, mjOBJ_JOINT, j);
+      int type = m->jnt_type[j];
+      bool qpos = field == ChannelKind::kQpos;
+      int count = type == mjJNT_FREE ? (qpos ? 7 : 6)
+                : (type == mjJNT_BALL ? (qpos ? 4 : 3) : 1);
+      plan->Add(schema, name ? name : "(noname)", field, type,
+                JointSource(field),
+                qpos ? m->jnt_qposadr[j] : m->jnt_dofadr[j], count);
+    }
+  }
+
+  for (int s = 0; s < m->nsensor; ++s) {
+    const char* name = mj_id2name(m, mjOBJ_SENSOR, s);
+    if (!filter.Included(ChannelFilter::kSensor, name) ||
+        filter.Excluded(ChannelFilter::kSensor, name)) {
+      continue;
+    }
+    plan->Add(schema, name ? name : "(noname)", ChannelKind::kSensor,
+              m->sensor_type[s], GatherPlan::kSensordata, m->sensor_adr[s],
+              m->sensor_dim[s]);
+  }
+
+  for (ChannelKind field : cfg.fields) {
+    if (field == ChannelKind::kNcon) {
+      plan->AddInt(schema, "ncon", field, offsetof(mjData, ncon));
+    } else if (field == ChannelKind::kEnergy) {
+      plan->Add(schema, "energy", field, 0, GatherPlan::kEnergy, 0, 2);
+    } else if (field == ChannelKind::kNefc) {
+      plan->AddInt(schema, "nefc", field, offsetof(mjData, nefc));
+    } else if (field == ChannelKind::kTimer) {
+      plan->AddTelemetry(schema, "timer", field, GatherPlan::kTimer);
+    } else if (field == ChannelKind::kSolver) {
+      plan->AddTelemetry(schema, "solver", field, GatherPlan::kSolver);
+    } else if (field == ChannelKind::kArena) {
+      plan->AddTelemetry(schema, "arena", field, GatherPlan::kArena);
+    }
+  }
+}
+
+// 文本格式输出。只依赖 FrameSchema，写线程不访问 mjModel。
+class TextSink : public FrameSink {
+ public:
+  TextSink(const FrameSchema& schema, std::FILE* file, bool owns_file)
+      : file_(file), owns_file_(owns_file) {
+    // 每个关节字段都按同一关节顺序登记：该字段的第 k 个通道属于第 k 个关节
+    std::vector<int> next(kNumChannelKinds, 0);
+    for (const Channel& c : schema.channels) {
+      if (IsJointChannel(c.kind)) {
+        int& k = next[static_cast<int>(c.kind)];
+        if (k == static_cast<int>(joints_.size())) joints_.emplace_back();
+        joints_[k++].push_back(c);
+      } else if (c.kind == ChannelKind::kSensor) {
+        sensors_.push_back(c);
+      } else {
+        globals_.push_back(c);
+      }
+    }
+  }
+
+  ~TextSink() override {
+    if (owns_file_ && file_) std::fclose(file_);
+  }
+
+  void Write(const double* frame) override {
+    line_.clear();
+    if (!header_emitted_) {
+      line_ += "# inspector: joints and sensors\n";
+      line_ += "# joints: name";
+      if (!joints_.empty()) {
+        for (const Channel& c : joints_[0]) {
+          line_ += std::string(" ") + ChannelKindName(c.kind);
+        }
+      }
+      line_ += "\n";
+      line_ += "# sensors: name type dim data...\n";
+      header_emitted_ = true;
+    }
+    line_ += "t=" + std::to_string(frame[0]) + "\n";
+    if (!globals_.empty()) {
+      line_ += "F";
+      for (const Channel& g : globals_) {
+        line_ += std::string(" ") + ChannelKindName(g.kind) + "=";
+        AppendValues(frame, g);
+      }
+      line_ += "\n";
+    }
+    // 球关节、自由关节的多个分量以逗号分隔
+    for (const std::vector<Channel>& joint : joints_) {
+      line_ += "J " + joint[0].name;
+      for (const Channel& c : joint) {
+        line_ += std::string(" ") + ChannelKindName(c.kind) + "=";
+        AppendValues(frame, c);
+      }
+      line_ += "\n";
+    }
+    for (const Channel& s : sensors_) {
+      line_ += "S " + s.name + " type=" + std::to_string(s.type) +
+               " dim=" + std::to_string(s.count) + " data=";
+      AppendValues(frame, s);
+      line_ += "\n";
+    }
+    std::fwrite(line_.data(), 1, line_.size(), file_);
+  }
+
+  void Flush() override { std::fflush(file_); }
+
+  void Close(uint64_t dropped) override {
+    if (dropped) {
+      std::fprintf(file_, "# dropped frames: %llu\n",
+                   static_cast<unsigned long long>(dropped));
+    }
+    std::fflush(file_);
+  }
+
+ private:
+  void AppendValues(const double* frame, const Channel& c) {
+    for (int k = 0; k < c.count; ++k) {
+      line_ += (k ? "," : "") + std::to_string(frame[c.offset + k]);
+    }
+  }
+
+  std::FILE* file_;
+  bool owns_file_;
+  bool header_emitted_ = false;
+  std::vector<std::vector<Channel>> joints_;   // 每个关节的各字段通道
+  std::vector<Channel> sensors_;
+  std::vector<Channel> globals_;              // ncon、energy 等
+  std::string line_;   // 复用的帧文本缓冲
+};
+
+// 二进制格式输出（见 log_format.h）：文件头只写一次，之后每帧原样写出。
+class BinarySink : public FrameSink {
+ public:
+  BinarySink(std::FILE* file, int frame_size)
+      : file_(file), frame_size_(frame_size) {}
+
+  ~BinarySink() override { std::fclose(file_); }
+
+  void Write(const double* frame) override {
+    std::fwrite(frame, sizeof(double), frame_size_, file_);
+  }
+
+  void Flush() override { std::fflush(file_); }
+
+ private:
+  std::FILE* file_;
+  size_t frame_size_;
+};
+
+// 压缩格式输出（见 log_codec.h）：帧攒满一块后编码写出，关闭时写块索引。
+class CompressedSink : public FrameSink {
+ public:
+  CompressedSink(std::FILE* file, const FrameSchema& schema, int block_frames)
+      : file_(file), writer_(file, schema, block_frames) {}
+
+  ~CompressedSink() override { std::fclose(file_); }
+
+  void Write(const double* frame) override { writer_.Add(frame); }
+
+  void Flush() override { std::fflush(file_); }
+
+  void Close(uint64_t /*dropped*/) override {
+    writer_.Finish();
+    std::fflush(file_);
+  }
+
+ private:
+  std::FILE* file_;
+  CompressedLogWriter writer_;
+};
+
+// stats 模式：在写线程上累加统计量，每个窗口向下游 sink 写出一条摘要帧。
+class StatsSink : public FrameSink {
+ public:
+  StatsSink(std::unique_ptr<OnlineStats> stats, std::unique_ptr<FrameSink> out)
+      : stats_(std::move(stats)), out_(std::move(out)),
+        summary_(stats_->summary_schema().frame_size) {}
+
+  void Write(const double* frame) override {
+    if (stats_->Add(frame, summary_.data())) out_->Write(summary_.data());
+  }
+
+  void Flush() override { out_->Flush(); }
+
+  void Close(uint64_t dropped) override {
+    // 最后一个未满的窗口也写出
+    if (stats_->Finish(summary_.data())) out_->Write(summary_.data());
+    out_->Close(dropped);
+  }
+
+ private:
+  std::unique_ptr<OnlineStats> stats_;
+  std::unique_ptr<FrameSink> out_;
+  std::vector<double> summary_;
+};
+
+// 日志文件路径；输出到 stdout（mode=print 或未设置）时为空
+std::string LogPath(const InspectorConfig& cfg) {
+  std::string mode = cfg.mode.value_or("print");
+  if (mode != "file" && mode != "binary" && mode != "compressed") return "";
+  if (cfg.file) return *cfg.file;
+  if (mode == "compressed") return "inspector.binz";
+  if (mode == "binary") return "inspector.bin";
+  return "inspector.log";
+}
+
+// 按 mode 打开日志输出；失败时返回 nullptr 并写入 error
+std::unique_ptr<FrameSink> OpenLogSink(const InspectorConfig& cfg,
+                                       const FrameSchema& log_schema,
+                                       std::string* error) {
+  std::string path = LogPath(cfg);
+  if (path.empty()) return std::make_unique<TextSink>(log_schema, stdout, false);
+
+  bool compressed = *cfg.mode == "compressed";
+  bool binary = compressed || *cfg.mode == "binary";
+  std::FILE* handle = std::fopen(path.c_str(), binary ? "wb" : "w");
+  if (!handle) {
+    *error = "failed to open file: " + path;
+    return nullptr;
+  }
+  if (!binary) return std::make_unique<TextSink>(log_schema, handle, true);
+  if (!WriteLogHeader(handle, log_schema, compressed)) {
+    *error = "failed to write header: " + path;
+    std::fclose(handle);
+    return nullptr;
+  }
+  if (compressed) {
+    return std::make_unique<CompressedSink>(handle, log_schema,
+                                            cfg.block_frames);
+  }
+  return std::make_unique<BinarySink>(handle, log_schema.frame_size);
+}
+
 }  // namespace
 
 std::unique_ptr<Inspector> Inspector::Create(const mjModel* m, int instance) {
   InspectorConfig cfg;
   cfg.mode = ReadStringAttr(m, instance, "mode");
   cfg.file = ReadStringAttr(m, instance, "file");
+  cfg.shm = ReadStringAttr(m, instance, "shm");
+  cfg.socket = ReadStringAttr(m, instance, "socket");
+  cfg.stream_rate_hz = ReadDoubleAttr(m, instance, "stream_rate")
+                           .value_or(cfg.stream_rate_hz);
+  cfg.stream_queue_frames = static_cast<int>(
+      ReadDoubleAttr(m, instance, "stream_queue")
+          .value_or(cfg.stream_queue_frames));
+  if (cfg.stream_queue_frames < 1) {
+    mju_warning("inspector: stream_queue must be positive, got %d",
+                cfg.stream_queue_frames);
+    return nullptr;
+  }
   cfg.rate_hz = ReadDoubleAttr(m, instance, "rate").value_or(10.0);
+  cfg.queue_frames = static_cast<int>(
+      ReadDoubleAttr(m, instance, "queue").value_or(cfg.queue_frames));
+  if (cfg.queue_frames < 1) {
+    mju_warning("inspector: queue must be positive, got %d", cfg.queue_frames);
+    return nullptr;
+  }
+  cfg.block_frames = static_cast<int>(
+      ReadDoubleAttr(m, instance, "block").value_or(cfg.block_frames));
+  if (cfg.block_frames < 1) {
+    mju_warning("inspector: block must be positive, got %d", cfg.block_frames);
+    return nullptr;
+  }
+  if (auto policy = ReadStringAttr(m, instance, "policy")) {
+    if (*policy == "drop") {
+      cfg.policy = OverflowPolicy::kDrop;
+    } else if (*policy == "block") {
+      cfg.policy = OverflowPolicy::kBlock;
+    } else {
+      mju_warning("inspector: unknown policy '%s' (expected drop or block)",
+                  policy->c_str());
+      return nullptr;
+    }
+  }
+
+  cfg.include = ReadStringAttr(m, instance, "include").value_or("");
+  cfg.exclude = ReadStringAttr(m, instance, "exclude").value_or("");
+  std::string error;
+  auto filter = ChannelFilter::Parse(cfg.include, cfg.exclude, &error);
+  if (!filter) {
+    mju_warning("inspector: %s", error.c_str());
+    return nullptr;
+  }
+  if (auto fields = ReadStringAttr(m, instance, "fields")) {
+    cfg.fields.clear();
+    std::istringstream ss(*fields);
+    std::string token;
+    while (ss >> token) {
+      auto field = ParseField(token);
+      if (!field) {
+        mju_warning("inspector: unknown field '%s'", token.c_str());
+        return nullptr;
+      }
+      if (std::find(cfg.fields.begin(), cfg.fields.end(), *field) ==
+          cfg.fields.end()) {
+        cfg.fields.push_back(*field);
+      }
+    }
+  }
+  if (std::find(cfg.fields.begin(), cfg.fields.end(), ChannelKind::kEnergy) !=
+          cfg.fields.end() &&
+      !(m->opt.enableflags & mjENBL_ENERGY)) {
+    mju_warning("inspector: field 'energy' requires the energy flag; "
+                "it will read zero");
+  }
+  if (auto install = ReadStringAttr(m, instance, "install_timer")) {
+    if (*install == "true") {
+      cfg.install_timer = true;
+    } else if (*install != "false") {
+      mju_warning("inspector: unknown install_timer '%s' "
+                  "(expected true or false)", install->c_str());
+      return nullptr;
+    }
+  }
+  bool timer_field = std::find(cfg.fields.begin(), cfg.fields.end(),
+                               ChannelKind::kTimer) != cfg.fields.end();
+  if (timer_field && !cfg.install_timer && !mjcb_time) {
+    mju_warning("inspector: field 'timer' needs mjcb_time; durations will read "
+                "zero unless the host sets it or install_timer=\"true\"");
+  }
+
+  std::optional<Trigger> trigger;
+  if (auto capture = ReadStringAttr(m, instance, "capture")) {
+    if (*capture == "trigger") {
+      cfg.triggered = true;
+    } else if (*capture != "continuous") {
+      mju_warning("inspector: unknown capture '%s' "
+                  "(expected continuous or trigger)", capture->c_str());
+      return nullptr;
+    }
+  }
+  if (cfg.triggered) {
+    cfg.trigger = ReadStringAttr(m, instance, "trigger").value_or("");
+    cfg.pretrigger = ReadDoubleAttr(m, instance, "pretrigger")
+                         .value_or(cfg.pretrigger);
+    cfg.posttrigger = ReadDoubleAttr(m, instance, "posttrigger")
+                          .value_or(cfg.posttrigger);
+    trigger = Trigger::Parse(m, cfg.trigger, &error);
+    if (!trigger) {
+      mju_warning("inspector: %s", error.c_str());
+      return nullptr;
+    }
+    if (cfg.pretrigger < 0 || cfg.posttrigger < 0) {
+      mju_warning("inspector: pretrigger and posttrigger must be non-negative");
+      return nullptr;
+    }
+  }
+
+  cfg.stats_window = ReadDoubleAttr(m, instance, "stats").value_or(0.0);
+  if (cfg.stats_window < 0) {
+    mju_warning("inspector: stats window must be non-negative");
+    return nullptr;
+  }
+  cfg.stats_bins = static_cast<int>(
+      ReadDoubleAttr(m, instance, "stats_bins").value_or(cfg.stats_bins));
+  if (cfg.stats_bins < 2) {
+    mju_warning("inspector: stats_bins must be at least 2, got %d",
+                cfg.stats_bins);
+    return nullptr;
+  }
+  if (auto quantiles = ReadStringAttr(m, instance, "stats_quantiles")) {
+    cfg.stats_quantiles.clear();
+    std::istringstream ss(*quantiles);
+    std::string token;
+    while (ss >> token) {
+      char* end = nullptr;
+      double q = std::strtod(token.c_str(), &end);
+      if (*end != '\0' || !(q > 0 && q < 1)) {
+        mju_warning("inspector: stats quantile '%s' is not in (0, 1)",
+                    token.c_str());
+        return nullptr;
+      }
+      cfg.stats_quantiles.push_back(q);
+    }
+  }
+  if (cfg.stats_window > 0 && cfg.triggered) {
+    mju_warning("inspector: stats cannot be combined with capture=trigger");
+    return nullptr;
+  }
+  if (auto multiplex = ReadStringAttr(m, instance, "multiplex")) {
+    if (*multiplex == "true") {
+      cfg.multiplex = true;
+    } else if (*multiplex != "false") {
+      mju_warning("inspector: unknown multiplex '%s' (expected true or false)",
+                  multiplex->c_str());
+      return nullptr;
+    }
+  }
+  if (cfg.multiplex && cfg.stats_window > 0) {
+    // 统计量按 rollout 分别累加才有意义，共享的写线程上没有这种划分
+    mju_warning("inspector: stats cannot be combined with multiplex=true");
+    return nullptr;
+  }
+
+  FrameSchema schema;
+  GatherPlan plan;
+  BuildPlan(m, cfg, *filter, &schema, &plan);
+
+  // stats 模式下日志记录的是摘要帧，其布局与原始帧不同
+  std::unique_ptr<OnlineStats> stats;
+  if (cfg.stats_window > 0) {
+    stats = std::make_unique<OnlineStats>(schema, cfg.stats_window,
+                                          cfg.stats_bins, cfg.stats_quantiles);
+  }
+  FrameSchema log_schema = stats ? stats->summary_schema() : schema;
+  if (cfg.multiplex) {
+    // 复用器在每帧末尾写入 rollout 编号
+    log_schema.Append("rollout", ChannelKind::kRollout, 0, 1);
+  }
+
+  std::unique_ptr<FrameHistory> history;
+  if (cfg.triggered) {
+    // 历史帧数按记录周期折算；写线程队列至少能容纳两段历史，
+    // 保证触发时一次性写出历史不会丢帧
+    double period = cfg.rate_hz > 0 ? 1.0 / cfg.rate_hz : m->opt.timestep;
+    int frames = static_cast<int>(std::ceil(cfg.pretrigger / period)) + 1;
+    history = std::make_unique<FrameHistory>(frames, schema.frame_size);
+    cfg.queue_frames = std::max(cfg.queue_frames, 2 * frames);
+  }
+  std::unique_ptr<ShmPublisher> shm;
+  if (cfg.shm) {
+    shm = ShmPublisher::Create(*cfg.shm, schema, &error);
+    if (!shm) {
+      mju_warning("inspector: %s", error.c_str());
+      return nullptr;
+    }
+  }
 
-  void* handle = nullptr;
-  if (cfg.mode && *cfg.mode == std::string("file")) {
-    const char* path = cfg.file ? cfg.file->c_str() : "inspector.log";
-    handle = std::fopen(path, "w");
-    if (!handle) {
-      mju_warning("inspector: failed to open file: %s", path);
+  std::unique_ptr<FrameWriter> stream;
+  if (cfg.socket) {
+    auto server = StreamServer::Create(*cfg.socket, schema,
+                                       cfg.stream_queue_frames, &error);
+    if (!server) {
+      mju_warning("inspector: %s", error.c_str());
       return nullptr;
     }
+    // 网络端永远不能拖慢物理线程，只用 drop 策略
+    stream = std::make_unique<FrameWriter>(
+        std::move(server), schema.frame_size, cfg.queue_frames,
+        OverflowPolicy::kDrop);
   }
-  return std::unique_ptr<Inspector>(new Inspector(cfg, handle));
+
+  bool none = cfg.mode && *cfg.mode == std::string("none");
+  if (none && cfg.triggered) {
+    mju_warning("inspector: capture=trigger needs a log output, not mode=none");
+    return nullptr;
+  }
+  std::unique_ptr<FrameSink> sink;
+  std::unique_ptr<LogMux::Rollout> rollout;
+  if (none) {
+    // 不写日志，只发布共享内存
+  } else if (cfg.multiplex) {
+    // 同一路径的所有 rollout 共用一个输出与写线程
+    std::string path = LogPath(cfg);
+    rollout = LogMux::Attach(
+        path.empty() ? "<stdout>" : path, cfg.mode.value_or("print"),
+        log_schema,
+        cfg.queue_frames, cfg.policy,
+        [&](std::string* e) { return OpenLogSink(cfg, log_schema, e); },
+        &error);
+    if (!rollout) {
+      mju_warning("inspector: %s", error.c_str());
+      return nullptr;
+    }
+  } else {
+    sink = OpenLogSink(cfg, log_schema, &error);
+    if (!sink) {
+      mju_warning("inspector: %s", error.c_str());
+      return nullptr;
+    }
+  }
+  if (sink && stats) {
+    sink = std::make_unique<StatsSink>(std::move(stats), std::move(sink));
+  }
+
+  std::unique_ptr<FrameWriter> writer;
+  if (sink) {
+    writer = std::make_unique<FrameWriter>(
+        std::move(sink), schema.frame_size, cfg.queue_frames, cfg.policy);
+  }
+  std::unique_ptr<Inspector> inspector(
+      new Inspector(cfg, std::move(plan), std::move(writer)));
+  inspector->trigger_ = std::move(trigger);
+  inspector->history_ = std::move(history);
+  inspector->shm_ = std::move(shm);
+  inspector->stream_ = std::move(stream);
+  inspector->rollout_ = std::move(rollout);
+  // 放在最后：前面任何一步失败都不会留下已安装的时钟
+  if (timer_field && cfg.install_timer) {
+    inspector->owns_timer_ = AcquireTimerCallback();
+  }
+  return inspector;
 }
 
-Inspector::Inspector(InspectorConfig config, void* file_handle)
-  : config_(std::move(config)), file_(file_handle) {}
+Inspector::Inspector(InspectorConfig config, GatherPlan plan,
+                     std::unique_ptr<FrameWriter> writer)
+  : config_(std::move(config)), plan_(std::move(plan)),
+    writer_(std::move(writer)) {}
 
-void Inspector::EmitHeaderOnce(const mjModel* m) {
-  if (header_emitted_) return;
-  EmitLine("# inspector: joints and sensors");
-  EmitLine("# joints: name qpos qvel");
-  EmitLine("# sensors: name type dim data...");
-  header_emitted_ = true;
+double* Inspector::AcquireLogFrame() {
+  return writer_ ? writer_->Acquire() : rollout_->Acquire();
 }
 
-void Inspector::EmitLine(const std::string& line) {
-  if (config_.mode && *config_.mode == std::string("file")) {
-    std::fprintf(reinterpret_cast<FILE*>(file_), "%s\n", line.c_str());
-    std::fflush(reinterpret_cast<FILE*>(file_));
+void Inspector::PublishLogFrame() {
+  if (writer_) {
+    writer_->Publish();
   } else {
-    std::fprintf(stdout, "%s\n", line.c_str());
-    std::fflush(stdout);
+    rollout_->Publish();
   }
 }
 
-void Inspector::EmitJoints(const mjModel* m, const mjData* d) {
-  for (int j = 0; j < m->njnt; ++j) {
-    const char* name = mj_id2name(m, mjOBJ_JOINT, j);
-    int qposadr = m->jnt_qposadr[j];
-    int dofadr  = m->jnt_dofadr[j];
-    int dofnum = (m->jnt_type[j] == mjJNT_HINGE || m->jnt_type[j] == mjJNT_SLIDE) ? 1
-               : (m->jnt_type[j] == mjJNT_BALL ? 3
-               : (m->jnt_type[j] == mjJNT_FREE ? 6 : 0));
-    // 仅打印标量关节（HINGE/SLIDE）
-    if (dofnum == 1) {
-      double q = d->qpos[qposadr];
-      double v = d->qvel[dofadr];
-      EmitLine(std::string("J ") + (name?name:"(noname)") +
-               " qpos=" + std::to_string(q) +
-               " qvel=" + std::to_string(v));
-    }
-  }
+Inspector::~Inspector() {
+  if (owns_timer_) ReleaseTimerCallback();
 }
 
-void Inspector::EmitSensors(const mjModel* m, const mjData* d) {
-  for (int s = 0; s < m->nsensor; ++s) {
-    const char* name = mj_id2name(m, mjOBJ_SENSOR, s);
-    int dim = m->sensor_dim[s];
-    int adr = m->sensor_adr[s];
-    int type = m->sensor_type[s];
-    std::string line = std::string("S ") + (name?name:"(noname)") +
-                       " type=" + std::to_string(type) +
-                       " dim=" + std::to_string(dim) + " data=";
-    for (int k = 0; k < dim; ++k) {
-      line += (k?",":"") + std::to_string(d->sensordata[adr+k]);
-    }
-    EmitLine(line);
+void Inspector::CaptureFrame(const mjData* d) {
+  double* frame = AcquireLogFrame();
+  if (!frame) return;   // 队列满，已计入 dropped
+  plan_.Gather(d, frame);
+  PublishLogFrame();
+}
+
+void Inspector::FlushHistory() {
+  for (int i = 0; i < history_->size(); ++i) {
+    double* frame = AcquireLogFrame();
+    if (!frame) continue;   // 队列满，已计入 dropped
+    std::memcpy(frame, history_->At(i),
+                sizeof(double) * history_->frame_size());
+    PublishLogFrame();
   }
+  history_->Clear();
+}
+
+void Inspector::Reset() {
+  reset_pending_ = history_ != nullptr;
+  if (trigger_) trigger_->Reset();
+  post_end_ = -1.0;
+  last_emit_time_ = -1.0;
+  last_stream_time_ = -1.0;
 }
 
 void Inspector::Compute(const mjModel* m, mjData* d, int /*instance*/) {
+  // 共享内存每步发布，直接采集到段内帧，不受 rate 限制
+  if (shm_) {
+    plan_.Gather(d, shm_->BeginWrite());
+    shm_->EndWrite();
+  }
+  if (stream_) {
+    double period = config_.stream_rate_hz > 0 ? 1.0/config_.stream_rate_hz : 0.0;
+    if (!(last_stream_time_ >= 0 && period > 0 &&
+          d->time < last_stream_time_ + period)) {
+      last_stream_time_ = d->time;
+      if (double* frame = stream_->Acquire()) {
+        plan_.Gather(d, frame);
+        stream_->Publish();
+      }
+    }
+  }
+  if (!writer_ && !rollout_) return;
+
   // 限速输出
   double period = (config_.rate_hz > 0 ? 1.0/config_.rate_hz : 0.0);
-  if (last_emit_time_ >= 0 && period > 0 && d->time < last_emit_time_ + period) {
-    return;
+  bool due = !(last_emit_time_ >= 0 && period > 0 &&
+               d->time < last_emit_time_ + period);
+
+  if (reset_pending_) {
+    reset_pending_ = false;
+    if (AutoResetWarned(d)) {
+      // 发散后的自动复位：复位前的历史正是要捕获的内容
+      FlushHistory();
+      ++triggers_;
+      last_trigger_ = "reset";
+      post_end_ = d->time + config_.posttrigger;
+      due = true;
+    } else {
+      history_->Clear();
+    }
   }
+
+  if (trigger_) {
+    // 触发条件每步检查，不受 rate 限制；触发当步必记
+    if (const char* reason = trigger_->Check(m, d)) {
+      if (post_end_ < 0 || d->time > post_end_) {
+        // 新的触发事件：先写出触发前历史
+        FlushHistory();
+        ++triggers_;
+        last_trigger_ = reason;
+      }
+      post_end_ = d->time + config_.posttrigger;
+      due = true;
+    }
+  }
+  if (!due) return;
   last_emit_time_ = d->time;
 
-  EmitHeaderOnce(m);
-  EmitLine(std::string("t=") + std::to_string(d->time));
-  EmitJoints(m, d);
-  EmitSensors(m, d);
+  if (trigger_ && (post_end_ < 0 || d->time > post_end_)) {
+    // 未触发：只写入内存历史，没有任何 I/O
+    plan_.Gather(d, history_->Push());
+    return;
+  }
+
+  // 物理线程只拷贝原始数据，格式化与写盘交给写线程
+  CaptureFrame(d);
 }
 
 void Inspector::RegisterPlugin() {
@@ -120,8 +726,13 @@ void Inspector::RegisterPlugin() {
   p.name = "sensor_read_publish";
   p.capabilityflags |= mjPLUGIN_PASSIVE;
 
-  static const char* kAttrs[] = {"mode","file","rate"};
-  p.nattribute = 3;
+  static const char* kAttrs[] = {"mode","file","rate","queue","policy",
+                                 "include","exclude","fields","capture",
+                                 "trigger","pretrigger","posttrigger","shm",
+                                 "socket","stream_rate","stream_queue",
+                                 "stats","stats_bins","stats_quantiles","block",
+                                 "multiplex","install_timer"};
+  p.nattribute = sizeof(kAttrs) / sizeof(kAttrs[0]);
   p.attributes = kAttrs;
 
   p.nstate = +[](const mjModel*, int){ return 0; };
@@ -133,19 +744,13 @@ void Inspector::RegisterPlugin() {
     return 0;
   };
 
-  p.reset = +[](const mjModel*, mjtNum*, void*, int){};
+  p.reset = +[](const mjModel*, mjtNum*, void* plugin_data, int){
+    if (plugin_data) reinterpret_cast<Inspector*>(plugin_data)->Reset();
+  };
 
   p.destroy = +[](mjData* d, int instance){
-    auto* obj = reinterpret_cast<Inspector*>(d->plugin_data[instance]);
-    if (obj) {
-      // 若打开了文件，则关闭
-      // 这里不在类析构里做，是因为插件对象寿命由 MuJoCo 托管
-      if (obj->config_.mode && *obj->config_.mode == std::string("file") && obj->file_) {
-        std::fclose(reinterpret_cast<FILE*>(obj->file_));
-        obj->file_ = nullptr;
-      }
-    }
-    delete obj;
+    // 析构时排空队列、回收写线程并关闭文件
+    delete reinterpret_cast<Inspector*>(d->plugin_data[instance]);
     d->plugin_data[instance] = 0;
   };
 
@@ -157,4 +762,3 @@ void Inspector::RegisterPlugin() {
 }
 
 }  // namespace mujoco::plugin::inspector
-
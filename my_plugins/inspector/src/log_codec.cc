@@ -0,0 +1,498 @@
+#include "log_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+uint64_t Bits(double v) {
+  uint64_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  return u;
+}
+
+double FromBits(uint64_t u) {
+  double v;
+  std::memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+bool IsIntegerChannel(ChannelKind kind) {
+  return kind == ChannelKind::kNcon || kind == ChannelKind::kRollout ||
+         kind == ChannelKind::kNefc || kind == ChannelKind::kArena;
+}
+
+// 每个分量（不含 time）是否按整数编码
+std::vector<uint8_t> IntegerComponents(const FrameSchema& schema) {
+  std::vector<uint8_t> integer(schema.frame_size > 1 ? schema.frame_size - 1 : 0);
+  for (const Channel& c : schema.channels) {
+    if (!IsIntegerChannel(c.kind)) continue;
+    for (int k = 0; k < c.count; ++k) integer[c.offset - 1 + k] = 1;
+  }
+  return integer;
+}
+
+// ---- 位流 ----
+
+class BitWriter {
+ public:
+  explicit BitWriter(std::string* out) : out_(out) {}
+
+  // 写 value 的低 n 位（n <= 64），高位在前
+  void Write(uint64_t value, int n) {
+    if (n > 32) {
+      Write(value >> 32, n - 32);
+      n = 32;
+    }
+    if (n == 0) return;
+    value &= (uint64_t{1} << n) - 1;
+    acc_ = (acc_ << n) | value;
+    fill_ += n;
+    while (fill_ >= 8) {
+      fill_ -= 8;
+      out_->push_back(static_cast<char>(acc_ >> fill_));
+    }
+    acc_ &= (uint64_t{1} << fill_) - 1;
+  }
+
+  void Finish() {
+    if (fill_) out_->push_back(static_cast<char>(acc_ << (8 - fill_)));
+    acc_ = 0;
+    fill_ = 0;
+  }
+
+ private:
+  std::string* out_;
+  uint64_t acc_ = 0;
+  int fill_ = 0;
+};
+
+// 只统计位数，用于编码端比较各阶预测
+class BitCounter {
+ public:
+  void Write(uint64_t, int n) { bits_ += n; }
+  uint64_t bits() const { return bits_; }
+
+ private:
+  uint64_t bits_ = 0;
+};
+
+class BitReader {
+ public:
+  BitReader(const char* data, size_t size)
+      : data_(reinterpret_cast<const uint8_t*>(data)), nbits_(size * 8) {}
+
+  uint64_t Read(int n) {
+    if (pos_ + n > nbits_) {
+      ok_ = false;
+      pos_ = nbits_;
+      return 0;
+    }
+    uint64_t value = 0;
+    while (n > 0) {
+      int avail = 8 - static_cast<int>(pos_ & 7);
+      int take = std::min(avail, n);
+      uint64_t byte = data_[pos_ >> 3];
+      value = (value << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+      pos_ += take;
+      n -= take;
+    }
+    return value;
+  }
+
+  bool ok() const { return ok_; }
+
+ private:
+  const uint8_t* data_;
+  size_t nbits_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+int64_t SignExtend(uint64_t value, int n) {
+  uint64_t sign = uint64_t{1} << (n - 1);
+  return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+bool FitsSigned(int64_t v, int n) {
+  int64_t lim = int64_t{1} << (n - 1);
+  return v >= -lim && v < lim;
+}
+
+// ---- time：位模式二阶差分 ----
+
+struct DodBucket {
+  int prefix_bits;
+  uint64_t prefix;
+  int value_bits;
+};
+constexpr DodBucket kDodBuckets[] = {
+    {2, 0b10, 7}, {3, 0b110, 9}, {4, 0b1110, 12}, {5, 0b11110, 32}};
+
+template <typename Writer>
+void EncodeTime(Writer* w, const double* frames, int stride, int n) {
+  uint64_t prev = Bits(frames[0]);
+  w->Write(prev, 64);
+  uint64_t prev_delta = 0;
+  for (int i = 1; i < n; ++i) {
+    uint64_t u = Bits(frames[i * stride]);
+    uint64_t delta = u - prev;
+    int64_t dod = static_cast<int64_t>(delta - prev_delta);
+    prev = u;
+    prev_delta = delta;
+    if (dod == 0) {
+      w->Write(0, 1);
+      continue;
+    }
+    bool written = false;
+    for (const DodBucket& b : kDodBuckets) {
+      if (FitsSigned(dod, b.value_bits)) {
+        w->Write(b.prefix, b.prefix_bits);
+        w->Write(static_cast<uint64_t>(dod), b.value_bits);
+        written = true;
+        break;
+      }
+    }
+    if (!written) {
+      w->Write(0b11111, 5);
+      w->Write(static_cast<uint64_t>(dod), 64);
+    }
+  }
+}
+
+void DecodeTime(BitReader* r, double* frames, int stride, int n) {
+  uint64_t prev = r->Read(64);
+  frames[0] = FromBits(prev);
+  uint64_t prev_delta = 0;
+  for (int i = 1; i < n; ++i) {
+    int ones = 0;
+    while (ones < 5 && r->Read(1)) ++ones;
+    uint64_t dod = 0;
+    if (ones == 5) {
+      dod = r->Read(64);
+    } else if (ones > 0) {
+      int bits = kDodBuckets[ones - 1].value_bits;
+      dod = static_cast<uint64_t>(SignExtend(r->Read(bits), bits));
+    }
+    prev_delta += dod;
+    prev += prev_delta;
+    frames[i * stride] = FromBits(prev);
+  }
+}
+
+// ---- 整数通道：zigzag varint 差分 ----
+
+bool ExactInteger(double v, int64_t* n) {
+  if (!(v >= -9007199254740992.0 && v <= 9007199254740992.0)) return false;
+  if (v == 0 && std::signbit(v)) return false;   // -0.0 无法经整数还原
+  *n = static_cast<int64_t>(v);
+  return static_cast<double>(*n) == v;
+}
+
+template <typename Writer>
+void EncodeIntegers(Writer* w, const double* column, int stride, int n) {
+  int64_t prev = 0;
+  for (int i = 0; i < n; ++i) {
+    double v = column[i * stride];
+    int64_t value;
+    if (!ExactInteger(v, &value)) {
+      w->Write(1, 1);
+      w->Write(Bits(v), 64);
+      continue;
+    }
+    w->Write(0, 1);
+    int64_t delta = value - prev;
+    uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^
+                      static_cast<uint64_t>(delta >> 63);
+    do {
+      uint64_t group = zigzag & 0x7f;
+      zigzag >>= 7;
+      w->Write((zigzag ? 0x80 : 0) | group, 8);
+    } while (zigzag);
+    prev = value;
+  }
+}
+
+void DecodeIntegers(BitReader* r, double* column, int stride, int n) {
+  int64_t prev = 0;
+  for (int i = 0; i < n; ++i) {
+    if (r->Read(1)) {
+      column[i * stride] = FromBits(r->Read(64));
+      continue;
+    }
+    uint64_t zigzag = 0;
+    for (int shift = 0; shift < 64 && r->ok(); shift += 7) {
+      uint64_t byte = r->Read(8);
+      zigzag |= (byte & 0x7f) << shift;
+      if (!(byte & 0x80)) break;
+    }
+    int64_t delta = static_cast<int64_t>(zigzag >> 1) ^
+                    -static_cast<int64_t>(zigzag & 1);
+    prev += delta;
+    column[i * stride] = static_cast<double>(prev);
+  }
+}
+
+// ---- 浮点通道：Gorilla XOR ----
+
+// 第 i 个值的预测，只用已解码的值，编解码两端一致。
+// order 0 为上一值，1 为线性外推，2 为二次外推；历史不足时降阶。
+double Predict(const double* column, int stride, int i, int order) {
+  double a = column[(i - 1) * stride];
+  order = std::min(order, i - 1);
+  if (order <= 0) return a;
+  double b = column[(i - 2) * stride];
+  double pred = order == 1
+      ? a + (a - b)
+      : a + ((a - b) + ((a - b) - (b - column[(i - 3) * stride])));
+  return std::isfinite(pred) ? pred : a;
+}
+
+constexpr int kNumPredictors = 3;
+
+template <typename Writer>
+void EncodeFloats(Writer* w, const double* column, int stride, int n,
+                  int order) {
+  w->Write(Bits(column[0]), 64);
+  int window_lead = -1, window_trail = 0;
+  for (int i = 1; i < n; ++i) {
+    uint64_t x = Bits(column[i * stride]) ^
+                 Bits(Predict(column, stride, i, order));
+    if (x == 0) {
+      w->Write(0, 1);
+      continue;
+    }
+    int lead = std::min(__builtin_clzll(x), 31);
+    int trail = __builtin_ctzll(x);
+    if (window_lead >= 0 && lead >= window_lead && trail >= window_trail) {
+      w->Write(0b10, 2);
+      w->Write(x >> window_trail, 64 - window_lead - window_trail);
+    } else {
+      int meaningful = 64 - lead - trail;
+      w->Write(0b11, 2);
+      w->Write(lead, 5);
+      w->Write(meaningful & 63, 6);   // 64 记为 0
+      w->Write(x >> trail, meaningful);
+      window_lead = lead;
+      window_trail = trail;
+    }
+  }
+}
+
+void DecodeFloats(BitReader* r, double* column, int stride, int n,
+                  int order) {
+  column[0] = FromBits(r->Read(64));
+  int window_lead = 0, window_trail = 0;
+  for (int i = 1; i < n; ++i) {
+    uint64_t x = 0;
+    if (r->Read(1)) {
+      if (r->Read(1)) {
+        window_lead = static_cast<int>(r->Read(5));
+        int meaningful = static_cast<int>(r->Read(6));
+        if (meaningful == 0) meaningful = 64;
+        window_trail = std::max(0, 64 - window_lead - meaningful);
+      }
+      int meaningful = 64 - window_lead - window_trail;
+      x = r->Read(meaningful) << window_trail;
+    }
+    column[i * stride] = FromBits(Bits(Predict(column, stride, i, order)) ^ x);
+  }
+}
+
+// ---- 文件 ----
+
+template <typename T>
+bool PutRaw(std::FILE* file, const T& value) {
+  return std::fwrite(&value, sizeof(T), 1, file) == 1;
+}
+
+template <typename T>
+bool GetRaw(std::FILE* file, T* value) {
+  return std::fread(value, sizeof(T), 1, file) == 1;
+}
+
+}  // namespace
+
+BlockEncoder::BlockEncoder(const FrameSchema& schema, int block_frames)
+    : frame_size_(schema.frame_size),
+      block_frames_(std::max(1, block_frames)),
+      integer_(IntegerComponents(schema)),
+      frames_(static_cast<size_t>(block_frames_) * frame_size_) {}
+
+bool BlockEncoder::Add(const double* frame) {
+  std::memcpy(frames_.data() + static_cast<size_t>(nframe_) * frame_size_,
+              frame, sizeof(double) * frame_size_);
+  if (++nframe_ < block_frames_) return false;
+  Encode();
+  return true;
+}
+
+bool BlockEncoder::Finish() {
+  if (nframe_ == 0) return false;
+  Encode();
+  return true;
+}
+
+void BlockEncoder::Encode() {
+  payload_.clear();
+  BitWriter w(&payload_);
+  const double* frames = frames_.data();
+  EncodeTime(&w, frames, frame_size_, nframe_);
+  for (int c = 1; c < frame_size_; ++c) {
+    const double* column = frames + c;
+    if (integer_[c - 1]) {
+      EncodeIntegers(&w, column, frame_size_, nframe_);
+      continue;
+    }
+    int best = 0;
+    uint64_t best_bits = 0;
+    for (int order = 0; order < kNumPredictors; ++order) {
+      BitCounter counter;
+      EncodeFloats(&counter, column, frame_size_, nframe_, order);
+      if (order == 0 || counter.bits() < best_bits) {
+        best = order;
+        best_bits = counter.bits();
+      }
+    }
+    w.Write(best, 2);
+    EncodeFloats(&w, column, frame_size_, nframe_, best);
+  }
+  w.Finish();
+  encoded_frames_ = nframe_;
+  encoded_time_ = frames[0];
+  nframe_ = 0;
+}
+
+BlockDecoder::BlockDecoder(const FrameSchema& schema)
+    : frame_size_(schema.frame_size), integer_(IntegerComponents(schema)) {}
+
+bool BlockDecoder::Decode(const char* data, size_t size, int nframe,
+                          std::vector<double>* frames,
+                          std::string* error) const {
+  frames->resize(static_cast<size_t>(nframe) * frame_size_);
+  if (nframe == 0) return true;
+  BitReader r(data, size);
+  double* out = frames->data();
+  DecodeTime(&r, out, frame_size_, nframe);
+  for (int c = 1; c < frame_size_ && r.ok(); ++c) {
+    double* column = out + c;
+    if (integer_[c - 1]) {
+      DecodeIntegers(&r, column, frame_size_, nframe);
+    } else {
+      int order = static_cast<int>(r.Read(2));
+      if (order >= kNumPredictors) {
+        if (error) *error = "unknown predictor";
+        return false;
+      }
+      DecodeFloats(&r, column, frame_size_, nframe, order);
+    }
+  }
+  if (!r.ok()) {
+    if (error) *error = "truncated block";
+    return false;
+  }
+  return true;
+}
+
+CompressedLogWriter::CompressedLogWriter(std::FILE* file,
+                                         const FrameSchema& schema,
+                                         int block_frames)
+    : file_(file), encoder_(schema, block_frames) {}
+
+bool CompressedLogWriter::Add(const double* frame) {
+  return !encoder_.Add(frame) || WriteBlock();
+}
+
+bool CompressedLogWriter::Finish() {
+  bool ok = !encoder_.Finish() || WriteBlock();
+  long offset = std::ftell(file_);
+  ok = ok && offset >= 0;
+  ok = ok && PutRaw(file_, kIndexMarker);
+  ok = ok && PutRaw(file_, static_cast<uint32_t>(index_.size()));
+  for (const BlockIndexEntry& e : index_) ok = ok && PutRaw(file_, e);
+  ok = ok && PutRaw(file_, static_cast<uint64_t>(offset));
+  ok = ok && std::fwrite(kLogTrailerMagic, 1, sizeof(kLogTrailerMagic),
+                         file_) == sizeof(kLogTrailerMagic);
+  return ok;
+}
+
+bool CompressedLogWriter::WriteBlock() {
+  long offset = std::ftell(file_);
+  const std::string& payload = encoder_.payload();
+  index_.push_back({static_cast<uint64_t>(offset), encoder_.time(),
+                    static_cast<uint32_t>(encoder_.nframe()), 0});
+  return offset >= 0 && PutRaw(file_, kBlockMarker) &&
+         PutRaw(file_, static_cast<uint32_t>(encoder_.nframe())) &&
+         PutRaw(file_, static_cast<uint32_t>(payload.size())) &&
+         std::fwrite(payload.data(), 1, payload.size(), file_) ==
+             payload.size();
+}
+
+CompressedLogReader::CompressedLogReader(std::FILE* file,
+                                         const FrameSchema& schema)
+    : file_(file), frame_size_(schema.frame_size), decoder_(schema) {}
+
+bool CompressedLogReader::Next(double* frame) {
+  while (cursor_ >= nframe_) {
+    if (!ReadBlock()) return false;
+  }
+  std::memcpy(frame,
+              frames_.data() + static_cast<size_t>(cursor_) * frame_size_,
+              sizeof(double) * frame_size_);
+  ++cursor_;
+  return true;
+}
+
+bool CompressedLogReader::ReadBlock() {
+  uint32_t marker, nframe, nbytes;
+  if (!GetRaw(file_, &marker) || marker != kBlockMarker) return false;
+  if (!GetRaw(file_, &nframe) || !GetRaw(file_, &nbytes)) return false;
+  payload_.resize(nbytes);
+  if (std::fread(payload_.data(), 1, nbytes, file_) != nbytes) return false;
+  if (!decoder_.Decode(payload_.data(), nbytes, static_cast<int>(nframe),
+                       &frames_, &error_)) {
+    return false;
+  }
+  nframe_ = static_cast<int>(nframe);
+  cursor_ = 0;
+  return true;
+}
+
+bool CompressedLogReader::Seek(double time) {
+  uint64_t index_offset;
+  char magic[sizeof(kLogTrailerMagic)];
+  long trailer = static_cast<long>(sizeof(index_offset) + sizeof(magic));
+  if (std::fseek(file_, -trailer, SEEK_END) != 0 ||
+      !GetRaw(file_, &index_offset) ||
+      std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+      std::memcmp(magic, kLogTrailerMagic, sizeof(magic)) != 0) {
+    error_ = "log has no block index";
+    return false;
+  }
+  uint32_t marker, nblock;
+  if (std::fseek(file_, static_cast<long>(index_offset), SEEK_SET) != 0 ||
+      !GetRaw(file_, &marker) || marker != kIndexMarker ||
+      !GetRaw(file_, &nblock)) {
+    error_ = "corrupt block index";
+    return false;
+  }
+  std::vector<BlockIndexEntry> index(nblock);
+  for (BlockIndexEntry& e : index) {
+    if (!GetRaw(file_, &e)) {
+      error_ = "corrupt block index";
+      return false;
+    }
+  }
+  // 最后一个首帧时刻不晚于 time 的块；time 早于全部块时取第一块
+  auto it = std::upper_bound(
+      index.begin(), index.end(), time,
+      [](double t, const BlockIndexEntry& e) { return t < e.time; });
+  if (it != index.begin()) --it;
+  nframe_ = cursor_ = 0;
+  if (index.empty()) return true;
+  return std::fseek(file_, static_cast<long>(it->offset), SEEK_SET) == 0;
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,141 @@
+#include "log_format.h"
+
+#include <cstring>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+template <typename T>
+void Put(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+std::optional<FrameSchema> Fail(std::string* error, const char* msg) {
+  if (error) *error = msg;
+  return std::nullopt;
+}
+
+}  // namespace
+
+const char* ChannelKindName(ChannelKind kind) {
+  switch (kind) {
+    case ChannelKind::kQpos:   return "qpos";
+    case ChannelKind::kQvel:   return "qvel";
+    case ChannelKind::kSensor: return "sensor";
+    case ChannelKind::kQacc:   return "qacc";
+    case ChannelKind::kQfrcActuator: return "qfrc_actuator";
+    case ChannelKind::kNcon:   return "ncon";
+    case ChannelKind::kEnergy: return "energy";
+    case ChannelKind::kRollout: return "rollout";
+    case ChannelKind::kTimer:  return "timer";
+    case ChannelKind::kSolver: return "solver";
+    case ChannelKind::kNefc:   return "nefc";
+    case ChannelKind::kArena:  return "arena";
+  }
+  return "unknown";
+}
+
+std::string EncodeLogHeader(const FrameSchema& schema, bool compressed) {
+  std::string out(kLogMagic, sizeof(kLogMagic));
+  Put<uint32_t>(&out, compressed ? kLogVersionCompressed : kLogVersion);
+  Put<uint32_t>(&out, kLogByteOrder);
+  Put<uint32_t>(&out, schema.frame_size);
+  Put<uint32_t>(&out, schema.channels.size());
+  for (const Channel& c : schema.channels) {
+    uint16_t len = static_cast<uint16_t>(
+        c.name.size() < 0xffff ? c.name.size() : 0xffff);
+    Put<uint8_t>(&out, static_cast<uint8_t>(c.kind));
+    Put<uint8_t>(&out, 0);
+    Put<uint16_t>(&out, len);
+    Put<int32_t>(&out, c.type);
+    Put<int32_t>(&out, c.offset);
+    Put<int32_t>(&out, c.count);
+    out.append(c.name.data(), len);
+  }
+  return out;
+}
+
+bool WriteLogHeader(std::FILE* file, const FrameSchema& schema,
+                    bool compressed) {
+  std::string header = EncodeLogHeader(schema, compressed);
+  return std::fwrite(header.data(), 1, header.size(), file) == header.size();
+}
+
+namespace {
+
+// 从字节流解析文件头；read(dst, n) 读满 n 字节时返回 true
+template <typename Read>
+std::optional<FrameSchema> ParseLogHeader(Read read, std::string* error,
+                                          bool* compressed) {
+  auto get = [&read](auto* value) { return read(value, sizeof(*value)); };
+
+  char magic[sizeof(kLogMagic)];
+  if (!read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kLogMagic, sizeof(magic)) != 0) {
+    return Fail(error, "not an inspector binary log");
+  }
+  uint32_t version, byte_order, frame_size, nchannel;
+  if (!get(&version) || !get(&byte_order) ||
+      !get(&frame_size) || !get(&nchannel)) {
+    return Fail(error, "truncated header");
+  }
+  if (byte_order != kLogByteOrder) {
+    return Fail(error, "byte order of the log does not match this machine");
+  }
+  if (version == kLogVersionCompressed && compressed) {
+    *compressed = true;
+  } else if (version == kLogVersion) {
+    if (compressed) *compressed = false;
+  } else {
+    return Fail(error, "unsupported log version");
+  }
+
+  FrameSchema schema;
+  schema.frame_size = static_cast<int32_t>(frame_size);
+  schema.channels.resize(nchannel);
+  for (Channel& c : schema.channels) {
+    uint8_t kind, pad;
+    uint16_t len;
+    if (!get(&kind) || !get(&pad) || !get(&len) ||
+        !get(&c.type) || !get(&c.offset) || !get(&c.count)) {
+      return Fail(error, "truncated channel table");
+    }
+    c.kind = static_cast<ChannelKind>(kind);
+    c.name.resize(len);
+    if (!read(c.name.data(), len)) {
+      return Fail(error, "truncated channel table");
+    }
+    if (c.offset < 1 || c.count < 0 ||
+        c.offset + c.count > schema.frame_size) {
+      return Fail(error, "channel outside of frame");
+    }
+  }
+  return schema;
+}
+
+}  // namespace
+
+std::optional<FrameSchema> ReadLogHeader(std::FILE* file, std::string* error,
+                                         bool* compressed) {
+  return ParseLogHeader(
+      [file](void* dst, size_t n) {
+        return std::fread(dst, 1, n, file) == n;
+      },
+      error, compressed);
+}
+
+std::optional<FrameSchema> DecodeLogHeader(const char* data, size_t size,
+                                           std::string* error) {
+  size_t pos = 0;
+  return ParseLogHeader(
+      [data, size, &pos](void* dst, size_t n) {
+        if (size - pos < n) return false;
+        std::memcpy(dst, data + pos, n);
+        pos += n;
+        return true;
+      },
+      error, nullptr);
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,168 @@
+#include "log_mux.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 队列为空时写线程的轮询间隔，与 FrameWriter 相同
+constexpr auto kIdleSleep = std::chrono::microseconds(500);
+
+bool SameSchema(const FrameSchema& a, const FrameSchema& b) {
+  if (a.frame_size != b.frame_size ||
+      a.channels.size() != b.channels.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.channels.size(); ++i) {
+    const Channel& x = a.channels[i];
+    const Channel& y = b.channels[i];
+    if (x.name != y.name || x.kind != y.kind || x.type != y.type ||
+        x.offset != y.offset || x.count != y.count) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 进程内已打开的复用器。只持有弱引用：最后一个 rollout 退出后复用器
+// 随之关闭，之后再接入同一路径会重新打开（并截断）文件。
+std::mutex& RegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<std::string, std::weak_ptr<LogMux>>& Registry() {
+  static auto* registry = new std::map<std::string, std::weak_ptr<LogMux>>;
+  return *registry;
+}
+
+}  // namespace
+
+LogMux::Rollout::Rollout(std::shared_ptr<LogMux> mux,
+                         std::shared_ptr<Stream> stream)
+    : mux_(std::move(mux)), stream_(std::move(stream)) {}
+
+LogMux::Rollout::~Rollout() {
+  // 写线程排空本帧环后将其移除；复用器的最后一个引用在此释放
+  stream_->closed.store(true, std::memory_order_release);
+}
+
+int LogMux::Rollout::id() const { return stream_->id; }
+
+int LogMux::Rollout::frame_size() const { return stream_->ring.frame_size(); }
+
+uint64_t LogMux::Rollout::dropped() const {
+  return stream_->dropped.load(std::memory_order_relaxed);
+}
+
+double* LogMux::Rollout::Acquire() {
+  FrameRing& ring = stream_->ring;
+  double* slot = ring.TryAcquire();
+  if (!slot) {
+    if (stream_->policy == OverflowPolicy::kDrop) {
+      stream_->dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    while (!(slot = ring.TryAcquire())) std::this_thread::yield();
+  }
+  slot[ring.frame_size() - 1] = stream_->id;
+  return slot;
+}
+
+void LogMux::Rollout::Publish() { stream_->ring.Publish(); }
+
+std::unique_ptr<LogMux::Rollout> LogMux::Attach(
+    const std::string& key, const std::string& format,
+    const FrameSchema& schema, int capacity, OverflowPolicy policy,
+    const SinkFactory& open_sink, std::string* error) {
+  if (schema.channels.empty() ||
+      schema.channels.back().kind != ChannelKind::kRollout) {
+    *error = key + ": multiplexed schema must end with a rollout channel";
+    return nullptr;
+  }
+
+  std::shared_ptr<LogMux> mux;
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    std::weak_ptr<LogMux>& entry = Registry()[key];
+    mux = entry.lock();
+    if (!mux) {
+      auto sink = open_sink(error);
+      if (!sink) {
+        Registry().erase(key);
+        return nullptr;
+      }
+      mux.reset(new LogMux(format, schema, std::move(sink)));
+      entry = mux;
+    } else if (mux->format_ != format || !SameSchema(mux->schema_, schema)) {
+      *error = key + ": already opened by another rollout with a different "
+               "mode or channel set";
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<Stream> stream;
+  {
+    std::lock_guard<std::mutex> lock(mux->mutex_);
+    stream = std::make_shared<Stream>(mux->next_id_++, capacity,
+                                      schema.frame_size, policy);
+    mux->streams_.push_back(stream);
+  }
+  return std::unique_ptr<Rollout>(new Rollout(std::move(mux),
+                                              std::move(stream)));
+}
+
+LogMux::LogMux(std::string format, FrameSchema schema,
+               std::unique_ptr<FrameSink> sink)
+    : format_(std::move(format)), schema_(std::move(schema)),
+      sink_(std::move(sink)) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+LogMux::~LogMux() {
+  stop_.store(true, std::memory_order_release);
+  if (thread_.joinable()) thread_.join();
+}
+
+void LogMux::Run() {
+  for (;;) {
+    // 先读 stop_ 再排空，保证析构前发布的帧都被写出
+    bool stopping = stop_.load(std::memory_order_acquire);
+    bool pending = false;   // 本轮有输出
+    {
+      // 接入与退出很少发生，排空期间持锁只会让它们稍等；
+      // 物理线程写帧环不经过这把锁
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (std::shared_ptr<Stream>& s : streams_) {
+        // 先读 closed 再排空，保证退出前发布的帧都被写出
+        bool closed = s->closed.load(std::memory_order_acquire);
+        while (const double* frame = s->ring.TryPeek()) {
+          sink_->Write(frame);
+          s->ring.Release();
+          pending = true;
+        }
+        if (closed) {
+          retired_dropped_ += s->dropped.load(std::memory_order_relaxed);
+          s.reset();
+        }
+      }
+      streams_.erase(std::remove(streams_.begin(), streams_.end(), nullptr),
+                     streams_.end());
+    }
+    if (pending) sink_->Flush();
+    sink_->Poll();
+    if (stopping) break;
+    std::this_thread::sleep_for(kIdleSleep);
+  }
+
+  uint64_t dropped = retired_dropped_;
+  for (const std::shared_ptr<Stream>& s : streams_) {
+    dropped += s->dropped.load(std::memory_order_relaxed);
+  }
+  sink_->Close(dropped);
+}
+
+}  // namespace mujoco::plugin::inspector
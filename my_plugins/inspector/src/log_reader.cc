@@ -0,0 +1,215 @@
+#include "log_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include "log_codec.h"
+#include "log_format.h"
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 读一行（不含换行符）；文件结束且没有读到内容时返回 false
+bool ReadLine(std::FILE* file, std::string* line) {
+  line->clear();
+  char buffer[4096];
+  while (std::fgets(buffer, sizeof(buffer), file)) {
+    line->append(buffer);
+    if (!line->empty() && line->back() == '\n') {
+      line->pop_back();
+      return true;
+    }
+  }
+  return !line->empty();
+}
+
+bool StartsWith(const std::string& s, const char* prefix) {
+  return s.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+bool ParseKind(const std::string& name, ChannelKind* kind) {
+  for (int k = 0; k < kNumChannelKinds; ++k) {
+    if (name == ChannelKindName(static_cast<ChannelKind>(k))) {
+      *kind = static_cast<ChannelKind>(k);
+      return true;
+    }
+  }
+  return false;
+}
+
+// "a,b,c" 追加到 values，返回个数
+int ParseValues(const std::string& list, std::vector<double>* values) {
+  int count = 0;
+  const char* p = list.c_str();
+  while (*p) {
+    char* end = nullptr;
+    values->push_back(std::strtod(p, &end));
+    ++count;
+    if (end == p) break;
+    p = *end == ',' ? end + 1 : end;
+  }
+  return count;
+}
+
+}  // namespace
+
+std::unique_ptr<LogReader> LogReader::Open(const std::string& path,
+                                           std::string* error) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (!file) {
+    if (error) *error = "cannot open " + path;
+    return nullptr;
+  }
+
+  char magic[sizeof(kLogMagic)] = {};
+  bool binary = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                std::memcmp(magic, kLogMagic, sizeof(magic)) == 0;
+  std::rewind(file);
+
+  if (!binary) {
+    // 文本日志：解析首帧得到通道表，首帧留给第一次 Next
+    std::unique_ptr<LogReader> reader(new LogReader(file, FrameSchema()));
+    reader->text_ = true;
+    std::vector<Channel> channels;
+    if (!reader->ReadTextFrame(&reader->first_frame_, &channels)) {
+      if (error) *error = path + ": not an inspector log";
+      return nullptr;
+    }
+    for (Channel& c : channels) {
+      reader->schema_.Append(std::move(c.name), c.kind, c.type, c.count);
+    }
+    reader->first_pending_ = true;
+    return reader;
+  }
+
+  bool compressed = false;
+  auto schema = ReadLogHeader(file, error, &compressed);
+  if (!schema) {
+    std::fclose(file);
+    return nullptr;
+  }
+  std::unique_ptr<LogReader> reader(new LogReader(file, std::move(*schema)));
+  reader->data_offset_ = std::ftell(file);
+  if (compressed) {
+    reader->compressed_ =
+        std::make_unique<CompressedLogReader>(file, reader->schema_);
+  }
+  return reader;
+}
+
+LogReader::LogReader(std::FILE* file, FrameSchema schema)
+    : file_(file), schema_(std::move(schema)) {}
+
+LogReader::~LogReader() {
+  if (file_) std::fclose(file_);
+}
+
+bool LogReader::Next(double* frame) {
+  if (compressed_) return compressed_->Next(frame);
+  size_t n = static_cast<size_t>(schema_.frame_size);
+  if (text_) {
+    if (first_pending_) {
+      first_pending_ = false;
+      std::memcpy(frame, first_frame_.data(), sizeof(double) * n);
+      return true;
+    }
+    std::vector<double>& values = first_frame_;
+    if (!ReadTextFrame(&values, nullptr) || values.size() != n) return false;
+    std::memcpy(frame, values.data(), sizeof(double) * n);
+    return true;
+  }
+  return std::fread(frame, sizeof(double), n, file_) == n;
+}
+
+bool LogReader::Seek(double time) {
+  if (compressed_) return compressed_->Seek(time);
+  if (text_) return false;
+
+  // 按帧长二分：找到首个时刻大于 time 的帧，退一帧
+  long frame_bytes = static_cast<long>(sizeof(double)) * schema_.frame_size;
+  if (std::fseek(file_, 0, SEEK_END) != 0) return false;
+  long nframe = (std::ftell(file_) - data_offset_) / frame_bytes;
+  long lo = 0, hi = nframe;
+  while (lo < hi) {
+    long mid = lo + (hi - lo) / 2;
+    double t;
+    if (std::fseek(file_, data_offset_ + mid * frame_bytes, SEEK_SET) != 0 ||
+        std::fread(&t, sizeof(t), 1, file_) != 1) {
+      return false;
+    }
+    if (t <= time) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  long index = lo > 0 ? lo - 1 : 0;
+  return std::fseek(file_, data_offset_ + index * frame_bytes, SEEK_SET) == 0;
+}
+
+bool LogReader::ReadTextFrame(std::vector<double>* values,
+                              std::vector<Channel>* channels) {
+  // 找到本帧的 "t=" 行
+  while (!StartsWith(line_, "t=")) {
+    if (!ReadLine(file_, &line_)) return false;
+  }
+  values->clear();
+  values->push_back(std::strtod(line_.c_str() + 2, nullptr));
+
+  auto add = [&](std::string name, ChannelKind kind, int type,
+                 const std::string& list) {
+    int count = ParseValues(list, values);
+    if (channels) {
+      channels->push_back({std::move(name), kind, type, 0, count});
+    }
+  };
+
+  for (;;) {
+    if (!ReadLine(file_, &line_)) {
+      line_.clear();
+      return true;
+    }
+    if (StartsWith(line_, "t=")) return true;   // 下一帧开始
+    std::istringstream ss(line_);
+    std::string tag, name, token;
+    ss >> tag;
+    if (tag == "J") {
+      // J <name> qpos=.. qvel=.. ...
+      ss >> name;
+      while (ss >> token) {
+        size_t eq = token.find('=');
+        ChannelKind kind;
+        if (eq == std::string::npos || !ParseKind(token.substr(0, eq), &kind)) {
+          continue;
+        }
+        add(name, kind, 0, token.substr(eq + 1));
+      }
+    } else if (tag == "S") {
+      // S <name> type=<type> dim=<dim> data=..
+      ss >> name;
+      int type = 0;
+      while (ss >> token) {
+        if (StartsWith(token, "type=")) {
+          type = std::atoi(token.c_str() + 5);
+        } else if (StartsWith(token, "data=")) {
+          add(name, ChannelKind::kSensor, type, token.substr(5));
+        }
+      }
+    } else if (tag == "F") {
+      // F ncon=.. energy=..
+      while (ss >> token) {
+        size_t eq = token.find('=');
+        ChannelKind kind;
+        if (eq == std::string::npos || !ParseKind(token.substr(0, eq), &kind)) {
+          continue;
+        }
+        add(token.substr(0, eq), kind, 0, token.substr(eq + 1));
+      }
+    }
+    // 其余（# 注释、空行）忽略
+  }
+}
+
+}  // namespace mujoco::plugin::inspector
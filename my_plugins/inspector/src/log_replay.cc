@@ -0,0 +1,151 @@
+#include "log_replay.h"
+
+#include <string>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 向前跳过超过这么多帧（按当前帧间隔估算，与压缩日志默认块长相同）时
+// 定位而不是逐帧解码
+constexpr int kSeekFrames = 256;
+
+}  // namespace
+
+std::unique_ptr<LogReplay> LogReplay::Open(const mjModel* m,
+                                           const std::string& path,
+                                           std::string* error,
+                                           int rollout) {
+  std::unique_ptr<LogReplay> replay(new LogReplay(m, path, rollout));
+  if (!replay->Load(error)) return nullptr;
+  return replay;
+}
+
+LogReplay::LogReplay(const mjModel* m, std::string path, int rollout)
+    : m_(m), path_(std::move(path)), dq_(m->nv), rollout_(rollout) {}
+
+bool LogReplay::Load(std::string* error) {
+  reader_ = LogReader::Open(path_, error);
+  if (!reader_) return false;
+
+  std::vector<char> mapped(m_->njnt, 0);
+  for (const Channel& c : reader_->schema().channels) {
+    if (c.kind == ChannelKind::kRollout) rollout_offset_ = c.offset;
+    bool qpos = c.kind == ChannelKind::kQpos;
+    if (!qpos && c.kind != ChannelKind::kQvel) continue;
+    int j = mj_name2id(m_, mjOBJ_JOINT, c.name.c_str());
+    int type = j >= 0 ? m_->jnt_type[j] : -1;
+    int count = type == mjJNT_FREE ? (qpos ? 7 : 6)
+              : type == mjJNT_BALL ? (qpos ? 4 : 3) : 1;
+    if (j < 0 || c.count != count) {
+      ++ignored_channels_;
+      continue;
+    }
+    if (qpos) {
+      qpos_copy_.push_back({c.offset, m_->jnt_qposadr[j], count});
+      if (!mapped[j]) ++mapped_joints_;
+      mapped[j] = 1;
+    } else {
+      qvel_copy_.push_back({c.offset, m_->jnt_dofadr[j], count});
+    }
+  }
+  if (qpos_copy_.empty()) {
+    *error = path_ + ": no qpos channel matches a joint of the model";
+    return false;
+  }
+
+  // 多路复用日志中各 rollout 交错，整体时刻不单调，不能按时刻定位
+  seekable_ = rollout_offset_ < 0 && !reader_->text();
+  frame_.resize(reader_->schema().frame_size);
+  for (State* s : {&prev_, &next_}) {
+    s->qpos.assign(m_->qpos0, m_->qpos0 + m_->nq);
+    s->qvel.assign(m_->nv, 0);
+  }
+  if (rollout_offset_ < 0) {
+    rollout_ = -1;
+  } else if (rollout_ < 0) {
+    // 取首帧所属的 rollout；首帧随后按普通方式读入
+    if (!reader_->Next(frame_.data())) {
+      *error = path_ + ": log has no frames";
+      return false;
+    }
+    rollout_ = static_cast<int>(frame_[rollout_offset_]);
+    reader_ = LogReader::Open(path_, error);
+    if (!reader_) return false;
+  }
+  if (!Read(&prev_)) {
+    *error = rollout_ < 0 ? path_ + ": log has no frames"
+                          : path_ + ": no frames of rollout " +
+                                std::to_string(rollout_);
+    return false;
+  }
+  start_time_ = prev_.time;
+  has_next_ = Read(&next_);
+  return true;
+}
+
+bool LogReplay::Read(State* state) {
+  do {
+    if (!reader_->Next(frame_.data())) return false;
+  } while (rollout_offset_ >= 0 && frame_[rollout_offset_] != rollout_);
+  state->time = frame_[0];
+  for (const Copy& c : qpos_copy_) {
+    for (int k = 0; k < c.count; ++k) state->qpos[c.adr + k] = frame_[c.offset + k];
+  }
+  for (const Copy& c : qvel_copy_) {
+    for (int k = 0; k < c.count; ++k) state->qvel[c.adr + k] = frame_[c.offset + k];
+  }
+  return true;
+}
+
+bool LogReplay::Seek(double time) {
+  if (!seekable_ || !reader_->Seek(time)) {
+    // 不能定位（或压缩日志没有索引）：从头读起，之后不再尝试定位
+    seekable_ = false;
+    std::string error;
+    auto reader = LogReader::Open(path_, &error);
+    if (!reader) return false;
+    reader_ = std::move(reader);
+  }
+  if (!Read(&prev_)) return false;
+  has_next_ = Read(&next_);
+  return true;
+}
+
+bool LogReplay::Apply(double time, mjData* d, Stage stage) {
+  // 向后总要重新定位；向前跳得较远时定位，免得逐帧解码
+  bool far = seekable_ && has_next_ &&
+             time > next_.time + kSeekFrames * (next_.time - prev_.time);
+  if (time < prev_.time || far) Seek(time);
+  while (has_next_ && next_.time <= time) {
+    std::swap(prev_, next_);
+    has_next_ = Read(&next_);
+  }
+
+  int nq = m_->nq, nv = m_->nv;
+  bool past_end = !has_next_ && time > prev_.time;
+  d->time = time;
+  if (!interpolate_ || !has_next_ || time <= prev_.time ||
+      next_.time <= prev_.time) {
+    mju_copy(d->qpos, prev_.qpos.data(), nq);
+    mju_copy(d->qvel, prev_.qvel.data(), nv);
+  } else {
+    double alpha = (time - prev_.time) / (next_.time - prev_.time);
+    mj_differentiatePos(m_, dq_.data(), 1.0, prev_.qpos.data(),
+                        next_.qpos.data());
+    mju_copy(d->qpos, prev_.qpos.data(), nq);
+    mj_integratePos(m_, d->qpos, dq_.data(), alpha);
+    for (int i = 0; i < nv; ++i) {
+      d->qvel[i] = (1 - alpha) * prev_.qvel[i] + alpha * next_.qvel[i];
+    }
+  }
+
+  if (stage == Stage::kForward) {
+    mj_forward(m_, d);
+  } else {
+    mj_kinematics(m_, d);
+  }
+  return !past_end;
+}
+
+}  // namespace mujoco::plugin::inspector
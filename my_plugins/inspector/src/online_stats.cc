@@ -0,0 +1,172 @@
+#include "online_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// 固定统计量，分位数跟在其后
+const char* const kFixedStats[] = {"count", "mean", "std", "rms", "min", "max"};
+constexpr int kNumFixedStats = sizeof(kFixedStats) / sizeof(kFixedStats[0]);
+
+}  // namespace
+
+OnlineStats::OnlineStats(const FrameSchema& schema, double window, int bins,
+                         std::vector<double> quantiles)
+    : ncomp_(schema.frame_size - 1),
+      bins_(std::max(2, bins + (bins & 1))),
+      window_(window),
+      quantiles_(std::move(quantiles)),
+      count_(ncomp_), mean_(ncomp_), m2_(ncomp_), min_(ncomp_), max_(ncomp_),
+      lo_(ncomp_), width_(ncomp_),
+      hist_(static_cast<size_t>(ncomp_) * bins_) {
+  std::vector<std::string> stats(kFixedStats, kFixedStats + kNumFixedStats);
+  for (double q : quantiles_) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "p%g", 100 * q);
+    stats.push_back(name);
+  }
+  for (const std::string& stat : stats) {
+    for (const Channel& c : schema.channels) {
+      summary_schema_.Append(c.name + "/" + stat, c.kind, c.type, c.count);
+    }
+  }
+  Clear();
+}
+
+bool OnlineStats::Add(const double* frame, double* summary) {
+  double time = frame[0];
+  bool emitted = false;
+  if (frames_ > 0 && (time < start_ || time >= start_ + window_)) {
+    Summarize(summary);
+    Clear();
+    emitted = true;
+  }
+  if (frames_ == 0) start_ = time;
+  ++frames_;
+
+  const double* x = frame + 1;
+  for (int i = 0; i < ncomp_; ++i) {
+    double v = x[i];
+    if (!std::isfinite(v)) continue;
+    int64_t n = ++count_[i];
+    double delta = v - mean_[i];
+    mean_[i] += delta / n;
+    m2_[i] += delta * (v - mean_[i]);
+    min_[i] = std::min(min_[i], v);
+    max_[i] = std::max(max_[i], v);
+    Bin(i, v);
+  }
+  return emitted;
+}
+
+bool OnlineStats::Finish(double* summary) {
+  if (frames_ == 0) return false;
+  Summarize(summary);
+  Clear();
+  return true;
+}
+
+void OnlineStats::Clear() {
+  frames_ = 0;
+  std::fill(count_.begin(), count_.end(), 0);
+  std::fill(mean_.begin(), mean_.end(), 0.0);
+  std::fill(m2_.begin(), m2_.end(), 0.0);
+  std::fill(min_.begin(), min_.end(), kInf);
+  std::fill(max_.begin(), max_.end(), -kInf);
+  std::fill(width_.begin(), width_.end(), 0.0);
+  std::fill(hist_.begin(), hist_.end(), 0u);
+}
+
+void OnlineStats::Summarize(double* summary) const {
+  summary[0] = start_;
+  double* out = summary + 1;
+  for (int i = 0; i < ncomp_; ++i) {
+    int64_t n = count_[i];
+    double var = n ? m2_[i] / n : kNaN;
+    out[i] = static_cast<double>(n);
+    out[ncomp_ + i] = n ? mean_[i] : kNaN;
+    out[2*ncomp_ + i] = std::sqrt(var);
+    out[3*ncomp_ + i] = std::sqrt(mean_[i]*mean_[i] + var);
+    out[4*ncomp_ + i] = n ? min_[i] : kNaN;
+    out[5*ncomp_ + i] = n ? max_[i] : kNaN;
+    for (size_t q = 0; q < quantiles_.size(); ++q) {
+      out[(kNumFixedStats + q)*ncomp_ + i] =
+          n ? Quantile(i, quantiles_[q]) : kNaN;
+    }
+  }
+}
+
+void OnlineStats::Bin(int i, double x) {
+  uint32_t* hist = hist_.data() + static_cast<size_t>(i) * bins_;
+  double& lo = lo_[i];
+  double& width = width_[i];
+  int half = bins_ / 2;
+
+  if (count_[i] == 1) {
+    lo = x;
+    hist[0] = 1;
+    return;
+  }
+  if (width == 0) {
+    // 至今只见过 lo 一个取值，全部在 hist[0]；第二个取值确定初始量程
+    if (x == lo) {
+      ++hist[0];
+      return;
+    }
+    width = std::abs(x - lo) / (bins_ - 1);
+    if (!(width > 0)) {   // 两值之差下溢
+      width = 0;
+      ++hist[0];
+      return;
+    }
+    if (x < lo) {
+      hist[bins_ - 1] = hist[0];
+      hist[0] = 0;
+      lo = x;
+    }
+  }
+
+  // 量程不足时加倍：向下扩展时旧桶并入上半部分，向上扩展时并入下半部分
+  while (x < lo) {
+    for (int k = bins_ - 1; k >= half; --k) {
+      hist[k] = hist[2*(k - half)] + hist[2*(k - half) + 1];
+    }
+    std::fill(hist, hist + half, 0u);
+    lo -= bins_ * width;
+    width *= 2;
+  }
+  while (x >= lo + bins_ * width) {
+    for (int k = 0; k < half; ++k) hist[k] = hist[2*k] + hist[2*k + 1];
+    std::fill(hist + half, hist + bins_, 0u);
+    width *= 2;
+  }
+
+  int k = static_cast<int>((x - lo) / width);
+  ++hist[std::clamp(k, 0, bins_ - 1)];
+}
+
+double OnlineStats::Quantile(int i, double q) const {
+  if (width_[i] == 0) return lo_[i];
+  const uint32_t* hist = hist_.data() + static_cast<size_t>(i) * bins_;
+  double target = q * count_[i];
+  double cumulative = 0;
+  for (int k = 0; k < bins_; ++k) {
+    if (hist[k] && cumulative + hist[k] >= target) {
+      // 桶内按均匀分布线性插值
+      double v = lo_[i] + (k + (target - cumulative) / hist[k]) * width_[i];
+      return std::clamp(v, min_[i], max_[i]);
+    }
+    cumulative += hist[k];
+  }
+  return max_[i];
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,114 @@
+#include "shm_publisher.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <set>
+#include <utility>
+
+#include "log_format.h"
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+size_t AlignUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+// 进程内已创建的段名。同名的第二个发布者会截断、覆盖前者的段，并在析构时
+// 删除其段名，因此直接拒绝；跨进程的同名段仍按覆盖处理。
+std::mutex& RegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::set<std::string>& Registry() {
+  static auto* registry = new std::set<std::string>;
+  return *registry;
+}
+
+// 段创建失败时归还段名
+void Unregister(const std::string& name) {
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  Registry().erase(name);
+}
+
+}  // namespace
+
+std::unique_ptr<ShmPublisher> ShmPublisher::Create(const std::string& name,
+                                                   const FrameSchema& schema,
+                                                   std::string* error) {
+  std::string table = EncodeLogHeader(schema);
+  size_t schema_offset = sizeof(ShmHeader);
+  size_t frame_offset = AlignUp(schema_offset + table.size(), 64);
+  size_t size = frame_offset + sizeof(double) * schema.frame_size;
+
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    if (!Registry().insert(name).second) {
+      *error = name + ": already published by another instance in this "
+               "process; give each rollout its own shm name";
+      return nullptr;
+    }
+  }
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    *error = "shm_open(" + name + "): " + std::strerror(errno);
+    Unregister(name);
+    return nullptr;
+  }
+  // 先截断为 0 再扩展，保证旧段内容（尤其 magic）被清零
+  if (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    *error = "ftruncate(" + name + "): " + std::strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    Unregister(name);
+    return nullptr;
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    *error = "mmap(" + name + "): " + std::strerror(errno);
+    shm_unlink(name.c_str());
+    Unregister(name);
+    return nullptr;
+  }
+
+  char* bytes = static_cast<char*>(base);
+  ShmHeader* header = new (base) ShmHeader;
+  header->version = kShmVersion;
+  header->frame_size = static_cast<uint32_t>(schema.frame_size);
+  header->schema_offset = static_cast<uint32_t>(schema_offset);
+  header->schema_size = static_cast<uint32_t>(table.size());
+  header->frame_offset = static_cast<uint32_t>(frame_offset);
+  header->writer_pid = static_cast<uint32_t>(getpid());
+  header->sequence.store(0, std::memory_order_relaxed);
+  std::memcpy(bytes + schema_offset, table.data(), table.size());
+
+  // magic 最后写入：读者看到 magic 即可安全读取其余字段
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header->magic, kShmMagic, sizeof(kShmMagic));
+
+  return std::unique_ptr<ShmPublisher>(new ShmPublisher(name, base, size));
+}
+
+ShmPublisher::ShmPublisher(std::string name, void* base, size_t size)
+    : name_(std::move(name)), base_(base), size_(size),
+      header_(static_cast<ShmHeader*>(base)),
+      frame_(reinterpret_cast<double*>(static_cast<char*>(base) +
+                                       header_->frame_offset)) {}
+
+ShmPublisher::~ShmPublisher() {
+  munmap(base_, size_);
+  shm_unlink(name_.c_str());
+  Unregister(name_);
+}
+
+}  // namespace mujoco::plugin::inspector
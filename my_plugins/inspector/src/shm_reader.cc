@@ -0,0 +1,116 @@
+#include "shm_reader.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#include "log_format.h"
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 等待写入时每隔这么多轮检查一次发布者进程是否还在
+constexpr int kAliveCheckInterval = 64;
+
+// pid 对应的进程是否存在；无权发信号（EPERM）也说明进程存在
+bool ProcessAlive(uint32_t pid) {
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+}
+
+std::unique_ptr<ShmReader> Fail(std::string* error, std::string msg) {
+  if (error) *error = std::move(msg);
+  return nullptr;
+}
+
+}  // namespace
+
+std::unique_ptr<ShmReader> ShmReader::Open(const std::string& name,
+                                           std::string* error) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return Fail(error, "shm_open(" + name + "): " + std::strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+    close(fd);
+    return Fail(error, name + ": segment not initialized");
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return Fail(error, "mmap(" + name + "): " + std::strerror(errno));
+  }
+
+  const ShmHeader* header = static_cast<const ShmHeader*>(base);
+  bool ok = std::memcmp(header->magic, kShmMagic, sizeof(kShmMagic)) == 0;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  std::string msg;
+  if (!ok) {
+    msg = name + ": segment not initialized";
+  } else if (header->version != kShmVersion) {
+    msg = name + ": unsupported segment version";
+  } else if (header->schema_offset + header->schema_size > size ||
+             header->frame_offset + sizeof(double) * header->frame_size > size) {
+    msg = name + ": segment truncated";
+  }
+  if (!msg.empty()) {
+    munmap(base, size);
+    return Fail(error, msg);
+  }
+
+  auto schema = DecodeLogHeader(
+      static_cast<const char*>(base) + header->schema_offset,
+      header->schema_size, error);
+  if (!schema) {
+    munmap(base, size);
+    return nullptr;
+  }
+  return std::unique_ptr<ShmReader>(
+      new ShmReader(base, size, std::move(*schema)));
+}
+
+ShmReader::ShmReader(const void* base, size_t size, FrameSchema schema)
+    : base_(base), size_(size), header_(static_cast<const ShmHeader*>(base)),
+      frame_(reinterpret_cast<const double*>(
+          static_cast<const char*>(base) + header_->frame_offset)),
+      schema_(std::move(schema)) {}
+
+ShmReader::~ShmReader() {
+  munmap(const_cast<void*>(base_), size_);
+}
+
+std::optional<uint64_t> ShmReader::WaitForWriter(
+    std::chrono::steady_clock::time_point deadline) const {
+  for (int spin = 1;; ++spin) {
+    uint64_t seq = sequence();
+    if (!(seq & 1)) return seq;
+    if (std::chrono::steady_clock::now() >= deadline) return std::nullopt;
+    if (spin % kAliveCheckInterval == 0 && !ProcessAlive(writer_pid())) {
+      return std::nullopt;
+    }
+    std::this_thread::yield();
+  }
+}
+
+std::optional<uint64_t> ShmReader::Snapshot(
+    double* out, std::chrono::nanoseconds timeout) const {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  size_t bytes = sizeof(double) * schema_.frame_size;
+  for (;;) {
+    std::optional<uint64_t> seq = WaitForWriter(deadline);
+    if (!seq) return std::nullopt;
+    std::memcpy(out, frame_, bytes);
+    if (Validate(*seq)) return seq;
+    // 发布者写得比拷贝快时可能一直校验失败，同样受 deadline 限制
+    if (std::chrono::steady_clock::now() >= deadline) return std::nullopt;
+  }
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,134 @@
+#include "stream_client.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "log_format.h"
+#include "stream_protocol.h"
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 单条消息的负载上限，防止错误的长度字段导致巨量分配
+constexpr uint32_t kMaxPayload = 64u << 20;
+
+bool ReadAll(int fd, void* data, size_t size) {
+  char* p = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<StreamClient> StreamClient::Connect(const std::string& path,
+                                                    std::string* error) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    if (error) *error = "socket path '" + path + "' is empty or too long";
+    return nullptr;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 ||
+      connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    if (error) *error = "connect(" + path + "): " + std::strerror(errno);
+    if (fd >= 0) close(fd);
+    return nullptr;
+  }
+
+  std::unique_ptr<StreamClient> client(new StreamClient(fd));
+  uint32_t type;
+  std::string payload;
+  if (!client->ReadMessage(&type, &payload) || type != kStreamSchema) {
+    if (error) *error = path + ": expected a channel table";
+    return nullptr;
+  }
+  auto schema = DecodeLogHeader(payload.data(), payload.size(), error);
+  if (!schema) return nullptr;
+  client->schema_ = std::move(*schema);
+  return client;
+}
+
+StreamClient::~StreamClient() { close(fd_); }
+
+bool StreamClient::Subscribe(double rate_hz, const std::string& patterns) {
+  char rate[64];
+  std::snprintf(rate, sizeof(rate), "%.17g", rate_hz);
+  std::string line = std::string("subscribe ") + rate + " " + patterns + "\n";
+  if (!WriteAll(fd_, line.data(), line.size())) {
+    error_ = std::string("send: ") + std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool StreamClient::Next(std::vector<double>* frame) {
+  uint32_t type;
+  std::string payload;
+  while (ReadMessage(&type, &payload)) {
+    if (type == kStreamSchema) {
+      auto schema = DecodeLogHeader(payload.data(), payload.size(), &error_);
+      if (!schema) return false;
+      schema_ = std::move(*schema);
+      ++generation_;
+    } else if (type == kStreamError) {
+      error_ = payload;
+    } else if (type == kStreamFrame) {
+      if (payload.size() != sizeof(double) * schema_.frame_size) {
+        error_ = "frame size does not match the channel table";
+        return false;
+      }
+      frame->resize(schema_.frame_size);
+      std::memcpy(frame->data(), payload.data(), payload.size());
+      return true;
+    }
+    // 未知消息类型：忽略，便于以后扩展协议
+  }
+  return false;
+}
+
+bool StreamClient::ReadMessage(uint32_t* type, std::string* payload) {
+  StreamMessageHeader header;
+  if (!ReadAll(fd_, &header, sizeof(header))) {
+    error_ = "connection closed";
+    return false;
+  }
+  if (header.size > kMaxPayload) {
+    error_ = "message too large";
+    return false;
+  }
+  payload->resize(header.size);
+  if (!ReadAll(fd_, payload->data(), header.size)) {
+    error_ = "connection closed";
+    return false;
+  }
+  *type = header.type;
+  return true;
+}
+
+}  // namespace mujoco::plugin::inspector
@@ -0,0 +1,326 @@
+#include "stream_server.h"
+
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "log_format.h"
+#include "stream_protocol.h"
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+// 单行命令的长度上限，超出视为协议错误
+constexpr size_t kMaxCommand = 4096;
+
+uint32_t MessageType(const std::string& message) {
+  StreamMessageHeader header;
+  std::memcpy(&header, message.data(), sizeof(header));
+  return header.type;
+}
+
+// 在 gather 末尾追加源帧区间，与上一段相邻时合并为一次拷贝
+void AddRange(std::vector<std::pair<int, int>>* gather, int offset, int count) {
+  if (!gather->empty() &&
+      gather->back().first + gather->back().second == offset) {
+    gather->back().second += count;
+  } else {
+    gather->emplace_back(offset, count);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<StreamServer> StreamServer::Create(const std::string& path,
+                                                   const FrameSchema& schema,
+                                                   int queue_frames,
+                                                   std::string* error) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    *error = "socket path '" + path + "' is empty or too long";
+    return nullptr;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  // 只替换残留的套接字文件，不误删普通文件
+  struct stat st;
+  if (lstat(path.c_str(), &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      *error = path + " exists and is not a socket";
+      return nullptr;
+    }
+    unlink(path.c_str());
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    *error = std::string("socket: ") + std::strerror(errno);
+    return nullptr;
+  }
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, 16) != 0) {
+    *error = "bind/listen(" + path + "): " + std::strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  return std::unique_ptr<StreamServer>(
+      new StreamServer(path, fd, schema, queue_frames));
+}
+
+StreamServer::StreamServer(std::string path, int listen_fd,
+                           FrameSchema schema, int queue_frames)
+    : path_(std::move(path)), listen_fd_(listen_fd),
+      schema_(std::move(schema)),
+      schema_message_(EncodeLogHeader(schema_)),
+      queue_frames_(queue_frames > 1 ? queue_frames : 1) {}
+
+StreamServer::~StreamServer() {
+  if (listen_fd_ >= 0) Close(0);
+}
+
+void StreamServer::Write(const double* frame) {
+  double time = frame[0];
+  for (const std::unique_ptr<Client>& c : clients_) {
+    if (time < c->last_time) c->last_time = -1.0;   // mj_resetData 后时间回退
+    if (c->rate_hz > 0 && c->last_time >= 0 &&
+        time < c->last_time + 1.0 / c->rate_hz) {
+      continue;
+    }
+    c->last_time = time;
+
+    std::string message =
+        NewMessage(kStreamFrame, sizeof(double) * c->schema.frame_size);
+    char* out = message.data() + sizeof(StreamMessageHeader);
+    std::memcpy(out, frame, sizeof(double));
+    out += sizeof(double);
+    for (const auto& [offset, count] : c->gather) {
+      std::memcpy(out, frame + offset, sizeof(double) * count);
+      out += sizeof(double) * count;
+    }
+    Enqueue(c.get(), std::move(message));
+  }
+}
+
+void StreamServer::Flush() {
+  for (const std::unique_ptr<Client>& c : clients_) Send(c.get());
+  Sweep();
+}
+
+void StreamServer::Poll() {
+  Accept();
+  for (const std::unique_ptr<Client>& c : clients_) {
+    Receive(c.get());
+    if (c->fd >= 0) Send(c.get());
+  }
+  Sweep();
+}
+
+void StreamServer::Close(uint64_t /*dropped*/) {
+  for (const std::unique_ptr<Client>& c : clients_) Disconnect(c.get());
+  clients_.clear();
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(path_.c_str());
+  }
+}
+
+void StreamServer::Accept() {
+  for (;;) {
+    int fd = accept4(listen_fd_, nullptr, nullptr,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;   // EAGAIN：没有新连接
+    auto client = std::make_unique<Client>();
+    client->fd = fd;
+    client->schema = schema_;
+    if (schema_.frame_size > 1) AddRange(&client->gather, 1, schema_.frame_size - 1);
+    std::string message = NewMessage(kStreamSchema, schema_message_.size());
+    std::memcpy(message.data() + sizeof(StreamMessageHeader),
+                schema_message_.data(), schema_message_.size());
+    Enqueue(client.get(), std::move(message));
+    clients_.push_back(std::move(client));
+  }
+}
+
+void StreamServer::Receive(Client* client) {
+  char buffer[512];
+  for (;;) {
+    ssize_t n = recv(client->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                   errno != EINTR)) {
+      Disconnect(client);
+      return;
+    }
+    if (n < 0) return;
+    client->command.append(buffer, n);
+
+    size_t eol;
+    while ((eol = client->command.find('\n')) != std::string::npos) {
+      std::string line = client->command.substr(0, eol);
+      client->command.erase(0, eol + 1);
+      Command(client, line);
+    }
+    if (client->command.size() > kMaxCommand) {
+      client->command.clear();
+      Disconnect(client);
+      return;
+    }
+  }
+}
+
+void StreamServer::Command(Client* client, const std::string& line) {
+  std::istringstream ss(line);
+  std::string verb, rate;
+  ss >> verb;
+  std::string error;
+  if (verb.empty()) return;
+  if (verb != "subscribe") {
+    error = "unknown command '" + verb + "'";
+  } else {
+    char* end = nullptr;
+    ss >> rate;
+    double hz = std::strtod(rate.c_str(), &end);
+    if (rate.empty() || *end != '\0' || !(hz >= 0)) {
+      error = "subscribe: bad rate '" + rate + "'";
+    } else {
+      std::vector<std::string> patterns;
+      for (std::string p; ss >> p;) patterns.push_back(p);
+      client->rate_hz = hz;
+      Subscribe(client, patterns);
+      return;
+    }
+  }
+  std::string message = NewMessage(kStreamError, error.size());
+  std::memcpy(message.data() + sizeof(StreamMessageHeader), error.data(),
+              error.size());
+  Enqueue(client, std::move(message));
+}
+
+void StreamServer::Subscribe(Client* client,
+                             const std::vector<std::string>& patterns) {
+  FrameSchema schema;
+  std::vector<std::pair<int, int>> gather;
+  for (const Channel& c : schema_.channels) {
+    std::string qualified = c.name + "." + ChannelKindName(c.kind);
+    bool match = patterns.empty();
+    for (const std::string& p : patterns) {
+      if (fnmatch(p.c_str(), c.name.c_str(), 0) == 0 ||
+          fnmatch(p.c_str(), qualified.c_str(), 0) == 0) {
+        match = true;
+        break;
+      }
+    }
+    if (!match) continue;
+    schema.Append(c.name, c.kind, c.type, c.count);
+    AddRange(&gather, c.offset, c.count);
+  }
+  client->schema = std::move(schema);
+  client->gather = std::move(gather);
+  client->last_time = -1.0;
+
+  // 旧布局的帧不再发送（正在发送的那条除外）
+  auto& q = client->queue;
+  for (size_t i = client->sent ? 1 : 0; i < q.size();) {
+    if (MessageType(q[i]) == kStreamFrame) {
+      spare_.push_back(std::move(q[i]));
+      q.erase(q.begin() + i);
+      --client->queue_frames;
+    } else {
+      ++i;
+    }
+  }
+
+  std::string table = EncodeLogHeader(client->schema);
+  std::string message = NewMessage(kStreamSchema, table.size());
+  std::memcpy(message.data() + sizeof(StreamMessageHeader), table.data(),
+              table.size());
+  Enqueue(client, std::move(message));
+}
+
+std::string StreamServer::NewMessage(uint32_t type, size_t size) {
+  std::string message;
+  if (!spare_.empty()) {
+    message = std::move(spare_.back());
+    spare_.pop_back();
+  }
+  StreamMessageHeader header{type, static_cast<uint32_t>(size)};
+  message.resize(sizeof(header) + size);
+  std::memcpy(message.data(), &header, sizeof(header));
+  return message;
+}
+
+void StreamServer::Enqueue(Client* client, std::string message) {
+  if (client->fd < 0) {
+    spare_.push_back(std::move(message));
+    return;
+  }
+  bool frame = MessageType(message) == kStreamFrame;
+  if (frame && client->queue_frames >= queue_frames_) {
+    // 慢客户端：丢弃最旧的未开始发送的帧
+    auto& q = client->queue;
+    auto oldest = std::find_if(
+        q.begin() + (client->sent ? 1 : 0), q.end(),
+        [](const std::string& m) { return MessageType(m) == kStreamFrame; });
+    ++client->dropped;
+    if (oldest == q.end()) {
+      spare_.push_back(std::move(message));
+      return;
+    }
+    spare_.push_back(std::move(*oldest));
+    q.erase(oldest);
+    --client->queue_frames;
+  }
+  if (frame) ++client->queue_frames;
+  client->queue.push_back(std::move(message));
+}
+
+void StreamServer::Send(Client* client) {
+  auto& q = client->queue;
+  while (client->fd >= 0 && !q.empty()) {
+    const std::string& front = q.front();
+    ssize_t n = send(client->fd, front.data() + client->sent,
+                     front.size() - client->sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        Disconnect(client);
+      }
+      return;
+    }
+    client->sent += n;
+    if (client->sent < front.size()) return;
+    if (MessageType(front) == kStreamFrame) --client->queue_frames;
+    spare_.push_back(std::move(q.front()));
+    q.pop_front();
+    client->sent = 0;
+  }
+}
+
+void StreamServer::Disconnect(Client* client) {
+  if (client->fd < 0) return;
+  close(client->fd);
+  client->fd = -1;
+  for (std::string& m : client->queue) spare_.push_back(std::move(m));
+  client->queue.clear();
+  client->queue_frames = 0;
+  client->sent = 0;
+}
+
+void StreamServer::Sweep() {
+  clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                [](const std::unique_ptr<Client>& c) {
+                                  return c->fd < 0;
+                                }),
+                 clients_.end());
+}
+
+}  // namespace mujoco::plugin::inspector
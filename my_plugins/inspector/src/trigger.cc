@@ -0,0 +1,136 @@
+#include "trigger.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+namespace mujoco::plugin::inspector {
+namespace {
+
+int WarningSum(const mjData* d) {
+  int sum = 0;
+  for (int i = 0; i < mjNWARNING; ++i) sum += d->warning[i].number;
+  return sum;
+}
+
+// 解析 "<数值>"，要求整串都是数字
+bool ParseNumber(const std::string& s, double* value) {
+  if (s.empty()) return false;
+  char* end = nullptr;
+  *value = std::strtod(s.c_str(), &end);
+  return end && *end == '\0';
+}
+
+}  // namespace
+
+bool AutoResetWarned(const mjData* d) {
+  return d->warning[mjWARN_BADQPOS].number > 0 ||
+         d->warning[mjWARN_BADQVEL].number > 0 ||
+         d->warning[mjWARN_BADQACC].number > 0;
+}
+
+std::optional<Trigger> Trigger::Parse(const mjModel* m,
+                                      const std::string& spec,
+                                      std::string* error) {
+  Trigger trigger;
+  std::istringstream ss(spec);
+  std::string token;
+  while (ss >> token) {
+    Condition c;
+    c.text = token;
+    if (token == "nan") {
+      c.type = Condition::kNan;
+    } else if (token == "warning") {
+      c.type = Condition::kWarning;
+    } else {
+      size_t op = token.find_first_of("<>");
+      if (op == std::string::npos || op == 0 ||
+          !ParseNumber(token.substr(op + 1), &c.value)) {
+        *error = "invalid trigger condition '" + token + "'";
+        return std::nullopt;
+      }
+      bool above = token[op] == '>';
+      std::string lhs = token.substr(0, op);
+      if (lhs == "ncon" || lhs == "dncon") {
+        if (!above) {
+          *error = "'" + token + "': contact triggers only support '>'";
+          return std::nullopt;
+        }
+        c.type = lhs == "ncon" ? Condition::kNcon : Condition::kNconJump;
+      } else {
+        // 传感器名，可带分量下标 NAME[i]
+        int component = 0;
+        size_t bracket = lhs.find('[');
+        if (bracket != std::string::npos) {
+          if (lhs.back() != ']') {
+            *error = "invalid trigger condition '" + token + "'";
+            return std::nullopt;
+          }
+          component = std::atoi(lhs.c_str() + bracket + 1);
+          lhs.erase(bracket);
+        }
+        int id = mj_name2id(m, mjOBJ_SENSOR, lhs.c_str());
+        if (id < 0) {
+          *error = "trigger sensor '" + lhs + "' not found";
+          return std::nullopt;
+        }
+        if (component < 0 || component >= m->sensor_dim[id]) {
+          *error = "trigger component out of range in '" + token + "'";
+          return std::nullopt;
+        }
+        c.type = above ? Condition::kAbove : Condition::kBelow;
+        c.adr = m->sensor_adr[id] + component;
+      }
+    }
+    trigger.conditions_.push_back(std::move(c));
+  }
+  if (trigger.conditions_.empty()) {
+    *error = "trigger capture needs at least one condition";
+    return std::nullopt;
+  }
+  return trigger;
+}
+
+const char* Trigger::Check(const mjModel* m, const mjData* d) {
+  // 计数类状态每步都更新；mj_resetData 后计数回落，不算触发
+  int warning = WarningSum(d);
+  bool warned = warning > last_warning_;
+  last_warning_ = warning;
+  int jump = d->ncon - last_ncon_;
+  last_ncon_ = d->ncon;
+
+  for (const Condition& c : conditions_) {
+    bool fired = false;
+    switch (c.type) {
+      case Condition::kNan:
+        // 关闭自动复位时坏值留在状态里；开启时由 AutoResetWarned 兜底
+        for (int i = 0; i < m->nq && !fired; ++i) {
+          fired = !std::isfinite(d->qpos[i]);
+        }
+        for (int i = 0; i < m->nv && !fired; ++i) {
+          fired = !std::isfinite(d->qvel[i]) || !std::isfinite(d->qacc[i]);
+        }
+        break;
+      case Condition::kWarning:
+        fired = warned;
+        break;
+      case Condition::kNcon:
+        fired = d->ncon > c.value;
+        break;
+      case Condition::kNconJump:
+        fired = jump > c.value;
+        break;
+      case Condition::kAbove:
+        fired = d->sensordata[c.adr] > c.value;
+        break;
+      case Condition::kBelow:
+        fired = d->sensordata[c.adr] < c.value;
+        break;
+    }
+    if (fired) return c.text.c_str();
+  }
+  return nullptr;
+}
+
+}  // namespace mujoco::plugin::inspector
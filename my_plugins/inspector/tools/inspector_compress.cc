@@ -0,0 +1,109 @@
+// -----------------------------------------------------------------------------
+//
+//  文件：tools/inspector_compress.cc
+//  说明：
+//    把二进制日志（mode="binary"）转换为压缩日志（mode="compressed"，
+//    格式见 log_codec.h），随后重新读出逐位比较，并报告压缩比。
+//    压缩日志可直接交给 inspector_csv。
+//
+//    用法：inspector_compress <input.bin> <output.binz> [block_frames]
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "log_codec.h"
+#include "log_format.h"
+#include "log_reader.h"
+
+using mujoco::plugin::inspector::CompressedLogWriter;
+using mujoco::plugin::inspector::LogReader;
+using mujoco::plugin::inspector::WriteLogHeader;
+
+namespace {
+
+long FileSize(const char* path) {
+  std::FILE* f = std::fopen(path, "rb");
+  if (!f) return -1;
+  std::fseek(f, 0, SEEK_END);
+  long size = std::ftell(f);
+  std::fclose(f);
+  return size;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3 || argc > 4) {
+    std::fprintf(stderr, "usage: %s <input.bin> <output.binz> [block_frames]\n",
+                 argv[0]);
+    return 2;
+  }
+  int block_frames = argc == 4 ? std::atoi(argv[3]) : 256;
+
+  std::string error;
+  auto input = LogReader::Open(argv[1], &error);
+  if (!input) {
+    std::fprintf(stderr, "inspector_compress: %s\n", error.c_str());
+    return 1;
+  }
+  const auto& schema = input->schema();
+  std::FILE* out = std::fopen(argv[2], "wb");
+  if (!out || !WriteLogHeader(out, schema, true)) {
+    std::fprintf(stderr, "inspector_compress: cannot write %s\n", argv[2]);
+    if (out) std::fclose(out);
+    return 1;
+  }
+
+  CompressedLogWriter writer(out, schema, block_frames);
+  std::vector<double> frame(schema.frame_size);
+  long nframe = 0;
+  bool ok = true;
+  while (ok && input->Next(frame.data())) {
+    ok = writer.Add(frame.data());
+    ++nframe;
+  }
+  ok = ok && writer.Finish();
+  ok = (std::fclose(out) == 0) && ok;
+  if (!ok) {
+    std::fprintf(stderr, "inspector_compress: write error on %s\n", argv[2]);
+    return 1;
+  }
+
+  // 逐位校验
+  auto original = LogReader::Open(argv[1], &error);
+  auto decoded = LogReader::Open(argv[2], &error);
+  if (!original || !decoded) {
+    std::fprintf(stderr, "inspector_compress: %s\n", error.c_str());
+    return 1;
+  }
+  std::vector<double> expect(schema.frame_size);
+  long checked = 0;
+  while (original->Next(expect.data())) {
+    if (!decoded->Next(frame.data()) ||
+        std::memcmp(frame.data(), expect.data(),
+                    sizeof(double) * frame.size()) != 0) {
+      std::fprintf(stderr, "inspector_compress: mismatch at frame %ld\n",
+                   checked);
+      return 1;
+    }
+    ++checked;
+  }
+  if (decoded->Next(frame.data())) {
+    std::fprintf(stderr, "inspector_compress: extra frames in output\n");
+    return 1;
+  }
+
+  long in_size = FileSize(argv[1]);
+  long out_size = FileSize(argv[2]);
+  std::fprintf(stderr,
+               "inspector_compress: %ld frames, %ld -> %ld bytes (%.1fx), "
+               "verified\n",
+               nframe, in_size, out_size,
+               out_size > 0 ? static_cast<double>(in_size) / out_size : 0.0);
+  return 0;
+}
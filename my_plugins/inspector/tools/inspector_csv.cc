@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------
+//
+//  文件：tools/inspector_csv.cc
+//  说明：
+//    把 sensor_read_publish 的二进制日志（mode="binary" 或 "compressed"）
+//    转换为 CSV。
+//    首行为列名：time，之后每个通道每个分量一列，形如
+//      <name>.qpos[0] / <name>.qvel[0] / <name>.sensor[0]
+//    数值以 %.17g 输出，可无损还原为 double。
+//
+//    用法：inspector_csv <input.bin> [output.csv]   （省略输出时写到 stdout）
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+#include "log_reader.h"
+
+using mujoco::plugin::inspector::Channel;
+using mujoco::plugin::inspector::ChannelKindName;
+using mujoco::plugin::inspector::LogReader;
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::fprintf(stderr, "usage: %s <input.bin> [output.csv]\n", argv[0]);
+    return 2;
+  }
+
+  std::string error;
+  auto reader = LogReader::Open(argv[1], &error);
+  if (!reader) {
+    std::fprintf(stderr, "inspector_csv: %s\n", error.c_str());
+    return 1;
+  }
+
+  std::FILE* out = stdout;
+  if (argc == 3) {
+    out = std::fopen(argv[2], "w");
+    if (!out) {
+      std::fprintf(stderr, "inspector_csv: cannot open %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  // 列按通道表顺序输出，与帧内偏移无关
+  std::vector<int> column;
+  std::fputs("time", out);
+  for (const Channel& c : reader->schema().channels) {
+    for (int k = 0; k < c.count; ++k) {
+      std::fprintf(out, ",%s.%s[%d]", c.name.c_str(), ChannelKindName(c.kind), k);
+      column.push_back(c.offset + k);
+    }
+  }
+  std::fputc('\n', out);
+
+  std::vector<double> frame(reader->schema().frame_size);
+  long nframe = 0;
+  while (reader->Next(frame.data())) {
+    std::fprintf(out, "%.17g", frame[0]);
+    for (int i : column) std::fprintf(out, ",%.17g", frame[i]);
+    std::fputc('\n', out);
+    ++nframe;
+  }
+
+  if (out != stdout) std::fclose(out);
+  std::fprintf(stderr, "inspector_csv: %ld frames\n", nframe);
+  return 0;
+}
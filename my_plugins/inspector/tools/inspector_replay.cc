@@ -0,0 +1,171 @@
+// -----------------------------------------------------------------------------
+//
+//  文件：tools/inspector_replay.cc
+//  说明：
+//    按 sensor_read_publish 的日志回放模型（见 log_replay.h），不做动力学积分。
+//    以固定采样率遍历 [from, to]，每个采样点写入插值后的 qpos/qvel 并计算
+//    运动学，最后报告回放速度（相对实时的倍数）。
+//
+//    用法：inspector_replay <model.xml> <log> [选项]
+//      --from T     起始时刻（默认首帧）
+//      --to T       结束时刻（默认末帧）
+//      --rate HZ    采样率，按仿真时间计（默认 60）
+//      --speed S    按墙钟以 S 倍速回放；0 为尽快（默认 0）
+//      --forward    调用 mj_forward 而不是 mj_kinematics
+//      --hold       不插值，取最近的前一帧
+//      --rollout N  多路复用日志中回放的 rollout（默认首帧所属的 rollout）
+//      --plugins D  加载目录 D 下的全部插件库（模型引用了插件时需要）
+//
+//    模型中的 sensor_read_publish 实例在回放中换成空插件：原插件在
+//    mj_makeData 时就会打开（并截断）日志、共享内存与套接字，回放的日志
+//    可能正是其中之一。其他插件照常创建与计算。
+//
+// -----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include <mujoco/mujoco.h>
+
+#include "log_replay.h"
+
+using mujoco::plugin::inspector::LogReplay;
+
+namespace {
+
+// 注册替换 sensor_read_publish 的空插件，返回其插件槽位
+int RegisterNullInspector() {
+  mjpPlugin p;
+  mjp_defaultPlugin(&p);
+  p.name = "inspector_replay.null";
+  p.capabilityflags |= mjPLUGIN_PASSIVE;
+  p.nstate = +[](const mjModel*, int){ return 0; };
+  p.init = +[](const mjModel*, mjData*, int){ return 0; };
+  p.compute = +[](const mjModel*, mjData*, int, int){};
+  return mjp_registerPlugin(&p);
+}
+
+// 把 m 中的 sensor_read_publish 实例指向空插件，返回替换的实例数。
+// 须在 mj_makeData 之前调用。
+int DisableInspectors(mjModel* m) {
+  int slot = -1;
+  if (!mjp_getPlugin("sensor_read_publish", &slot)) return 0;
+  int null_slot = -1;
+  int count = 0;
+  for (int i = 0; i < m->nplugin; ++i) {
+    if (m->plugin[i] != slot) continue;
+    if (null_slot < 0) null_slot = RegisterNullInspector();
+    m->plugin[i] = null_slot;
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr,
+                 "usage: %s <model.xml> <log> [--from T] [--to T] [--rate HZ] "
+                 "[--speed S] [--forward] [--hold] [--rollout N] "
+                 "[--plugins DIR]\n", argv[0]);
+    return 2;
+  }
+  double from = -std::numeric_limits<double>::infinity();
+  double to = std::numeric_limits<double>::infinity();
+  double rate = 60.0, speed = 0.0;
+  bool forward = false, hold = false;
+  int rollout = -1;
+  const char* plugins = nullptr;
+  for (int i = 3; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!std::strcmp(argv[i], "--from") && has_value) {
+      from = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--to") && has_value) {
+      to = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--rate") && has_value) {
+      rate = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--speed") && has_value) {
+      speed = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--rollout") && has_value) {
+      rollout = std::atoi(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--plugins") && has_value) {
+      plugins = argv[++i];
+    } else if (!std::strcmp(argv[i], "--forward")) {
+      forward = true;
+    } else if (!std::strcmp(argv[i], "--hold")) {
+      hold = true;
+    } else {
+      std::fprintf(stderr, "inspector_replay: unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (!(rate > 0) || speed < 0) {
+    std::fprintf(stderr, "inspector_replay: rate must be positive and "
+                         "speed non-negative\n");
+    return 2;
+  }
+
+  if (plugins) mj_loadAllPluginLibraries(plugins, nullptr);
+
+  char load_error[1000] = "";
+  mjModel* m = mj_loadXML(argv[1], nullptr, load_error, sizeof(load_error));
+  if (!m) {
+    std::fprintf(stderr, "inspector_replay: %s\n", load_error);
+    return 1;
+  }
+  if (int n = DisableInspectors(m)) {
+    std::fprintf(stderr, "inspector_replay: %d sensor_read_publish instance(s) "
+                 "disabled for replay\n", n);
+  }
+  mjData* d = mj_makeData(m);
+
+  std::string error;
+  auto replay = LogReplay::Open(m, argv[2], &error, rollout);
+  if (!replay) {
+    std::fprintf(stderr, "inspector_replay: %s\n", error.c_str());
+    mj_deleteData(d);
+    mj_deleteModel(m);
+    return 1;
+  }
+  replay->set_interpolate(!hold);
+  std::fprintf(stderr, "inspector_replay: %d joints mapped, %d channels "
+               "ignored\n", replay->mapped_joints(), replay->ignored_channels());
+  if (replay->rollout() >= 0) {
+    std::fprintf(stderr, "inspector_replay: replaying rollout %d\n",
+                 replay->rollout());
+  }
+
+  auto stage = forward ? LogReplay::Stage::kForward
+                       : LogReplay::Stage::kKinematics;
+  double start = from > replay->start_time() ? from : replay->start_time();
+  auto wall_start = std::chrono::steady_clock::now();
+  long nsample = 0;
+  double t = start;
+  for (; t <= to; t = start + nsample / rate) {
+    if (speed > 0) {
+      std::this_thread::sleep_until(
+          wall_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>((t - start) / speed)));
+    }
+    if (!replay->Apply(t, d, stage)) break;
+    ++nsample;
+  }
+  double wall = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - wall_start).count();
+  double covered = nsample > 0 ? (nsample - 1) / rate : 0.0;
+
+  std::fprintf(stderr,
+               "inspector_replay: %ld samples, %.3f s of log in %.3f s wall "
+               "(%.0fx real time)\n",
+               nsample, covered, wall, wall > 0 ? covered / wall : 0.0);
+
+  mj_deleteData(d);
+  mj_deleteModel(m);
+  return 0;
+}
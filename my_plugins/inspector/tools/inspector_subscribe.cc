@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------
+//
+//  文件：tools/inspector_subscribe.cc
+//  说明：
+//    sensor_read_publish 流式套接字（socket="<path>"）的最小客户端，
+//    也用作测试服务器时的替身订阅者。订阅后按 CSV 输出收到的帧，
+//    列名与 inspector_csv 相同；订阅生效（通道表变化）时重新输出表头。
+//
+//    用法：inspector_subscribe [-n nframe] <socket> [rate_hz [pattern ...]]
+//      -n      收到 nframe 帧后退出（默认一直运行到连接断开）
+//      rate_hz 订阅频率，0 表示服务器发出的每一帧（默认 0）
+//      pattern 通道通配符，如 "arm_*"、"*.qvel"（默认全部通道）
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "frame_schema.h"
+#include "stream_client.h"
+
+using mujoco::plugin::inspector::Channel;
+using mujoco::plugin::inspector::ChannelKindName;
+using mujoco::plugin::inspector::FrameSchema;
+using mujoco::plugin::inspector::StreamClient;
+
+namespace {
+
+void PrintHeader(const FrameSchema& schema) {
+  std::fputs("time", stdout);
+  for (const Channel& c : schema.channels) {
+    for (int k = 0; k < c.count; ++k) {
+      std::printf(",%s.%s[%d]", c.name.c_str(), ChannelKindName(c.kind), k);
+    }
+  }
+  std::fputc('\n', stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long limit = -1;
+  int arg = 1;
+  if (arg + 1 < argc && std::strcmp(argv[arg], "-n") == 0) {
+    limit = std::atol(argv[arg + 1]);
+    arg += 2;
+  }
+  if (arg >= argc) {
+    std::fprintf(stderr,
+                 "usage: %s [-n nframe] <socket> [rate_hz [pattern ...]]\n",
+                 argv[0]);
+    return 2;
+  }
+  const char* path = argv[arg++];
+  double rate_hz = arg < argc ? std::atof(argv[arg++]) : 0.0;
+  std::string patterns;
+  for (; arg < argc; ++arg) patterns += std::string(argv[arg]) + " ";
+
+  std::string error;
+  auto client = StreamClient::Connect(path, &error);
+  if (!client) {
+    std::fprintf(stderr, "inspector_subscribe: %s\n", error.c_str());
+    return 1;
+  }
+  if (!client->Subscribe(rate_hz, patterns)) {
+    std::fprintf(stderr, "inspector_subscribe: %s\n", client->error().c_str());
+    return 1;
+  }
+
+  // 订阅确认之前可能先收到按全部通道排布的帧，表头随通道表一起更新
+  int printed = -1;
+  std::vector<double> frame;
+  long nframe = 0;
+  while ((limit < 0 || nframe < limit) && client->Next(&frame)) {
+    if (printed != client->generation()) {
+      PrintHeader(client->schema());
+      printed = client->generation();
+    }
+    std::printf("%.17g", frame[0]);
+    for (size_t i = 1; i < frame.size(); ++i) std::printf(",%.17g", frame[i]);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+    ++nframe;
+  }
+  if (limit < 0 || nframe < limit) {
+    std::fprintf(stderr, "inspector_subscribe: %s\n", client->error().c_str());
+  }
+  std::fprintf(stderr, "inspector_subscribe: %ld frames\n", nframe);
+  return 0;
+}